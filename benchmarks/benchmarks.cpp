@@ -0,0 +1,374 @@
+// Microbenchmarks for the hot game kernels: raycasting, A*, collectible
+// placement and pickup, on the bundled levels and on synthetic large mazes.
+// Usage: benchmarks [--filter <text>] [--min-time <seconds>] [--json <file>]
+// Reports ns/op, heap allocations and bytes per op and throughput; --json
+// writes the same numbers in a form that can be diffed between builds. With
+// ALLOC_TRACKING the counts come from the game's tracker and include malloc.
+
+#include <raylib.h>
+#include "map.h"
+#include "level.h"
+#include "collectible.h"
+#include "pathfinding.h"
+#include "raycaster.h"
+#include "rng.h"
+#include "batchsim.h"
+#include "alloctrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef ALLOC_TRACKING
+static AllocCounts CurrentAllocs() {
+    return GetAllocTotals();
+}
+#else
+// Every heap allocation in the process goes through here (atomic: the
+// batch simulation allocates on its workers)
+static std::atomic<unsigned long long> allocationCount(0);
+static std::atomic<unsigned long long> allocationBytes(0);
+
+void* operator new(size_t size) {
+    allocationCount++;
+    allocationBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+static AllocCounts CurrentAllocs() {
+    AllocCounts counts;
+    counts.count = allocationCount;
+    counts.bytes = allocationBytes;
+    return counts;
+}
+#endif
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+    double bytesPerOp;
+    double itemsPerSecond;
+    const char* itemName; // What items/s counts, e.g. "rays"
+};
+
+struct BenchOptions {
+    const char* filter;
+    double minTime;
+    const char* jsonPath;
+};
+
+static BenchOptions options = { NULL, 0.5, NULL };
+static std::vector<BenchResult> results;
+static volatile long long benchSink; // Keeps results observable so work isn't optimized away
+
+// Run op (which returns the items it processed) until it has taken at least
+// options.minTime, growing the iteration count between attempts
+static void RunBench(const std::string& name, const char* itemName, const std::function<long long()>& op) {
+    if (options.filter && strstr(name.c_str(), options.filter) == NULL) return;
+    
+    op(); // Warm caches and any lazily grown buffers
+    long long iterations = 1;
+    for (;;) {
+        AllocCounts allocsBefore = CurrentAllocs();
+        long long items = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; i++) {
+            items += op();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        AllocCounts allocsAfter = CurrentAllocs();
+        
+        if (elapsed >= options.minTime || iterations >= (1LL << 40)) {
+            BenchResult result;
+            result.name = name;
+            result.iterations = iterations;
+            result.nsPerOp = elapsed * 1e9 / iterations;
+            result.allocsPerOp = (double)(allocsAfter.count - allocsBefore.count) / iterations;
+            result.bytesPerOp = (double)(allocsAfter.bytes - allocsBefore.bytes) / iterations;
+            result.itemsPerSecond = elapsed > 0.0 ? items / elapsed : 0.0;
+            result.itemName = itemName;
+            results.push_back(result);
+            printf("%-36s %12.0f %10.2f %12.0f %14.4g %s/s\n", name.c_str(), result.nsPerOp,
+                   result.allocsPerOp, result.bytesPerOp, result.itemsPerSecond, itemName);
+            fflush(stdout);
+            return;
+        }
+        
+        // Aim a bit past the target so the next attempt is usually the last
+        double scale = elapsed > 0.0 ? options.minTime * 1.4 / elapsed : 100.0;
+        if (scale > 100.0) scale = 100.0;
+        long long next = (long long)(iterations * scale);
+        iterations = next > iterations ? next : iterations + 1;
+    }
+}
+
+static bool WriteJson(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "benchmarks: cannot write %s\n", path);
+        return false;
+    }
+    fprintf(file, "{\n  \"context\": {\n");
+#ifdef __VERSION__
+    fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#ifdef NDEBUG
+    fprintf(file, "    \"assertions\": false,\n");
+#else
+    fprintf(file, "    \"assertions\": true,\n");
+#endif
+    fprintf(file, "    \"min_time_s\": %g\n  },\n  \"benchmarks\": [\n", options.minTime);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.2f, "
+                "\"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f, \"items_per_second\": %.1f, \"item\": \"%s\"}%s\n",
+                r.name.c_str(), r.iterations, r.nsPerOp, r.allocsPerOp, r.bytesPerOp, r.itemsPerSecond, r.itemName,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+// A map to run the kernels on, with a start point and a goal by the door
+struct BenchMap {
+    std::string name;
+    int level;              // Bundled level number, 0 for synthetic
+    const int* map;
+    int width;
+    int height;
+    Vector2 start;
+    Vector2 goal;
+    std::vector<int> storage; // Synthetic maps only
+};
+
+static Vector2 CellCenter(int x, int y) {
+    return { x + 0.5f, y + 0.5f };
+}
+
+// Center of the open cell closest to pos (some level starts sit in a wall)
+static Vector2 NearestOpenCell(const BenchMap& bench, Vector2 pos) {
+    int cx = (int)pos.x;
+    int cy = (int)pos.y;
+    for (int radius = 0; radius < bench.width + bench.height; radius++) {
+        for (int y = cy - radius; y <= cy + radius; y++) {
+            for (int x = cx - radius; x <= cx + radius; x++) {
+                if (x < 0 || x >= bench.width || y < 0 || y >= bench.height) continue;
+                if (bench.map[y * bench.width + x] == 0) return CellCenter(x, y);
+            }
+        }
+    }
+    return pos;
+}
+
+// Goal: the open cell next to the door
+static Vector2 FindDoorGoal(const BenchMap& bench) {
+    const int dx[4] = { -1, 1, 0, 0 };
+    const int dy[4] = { 0, 0, -1, 1 };
+    for (int y = 0; y < bench.height; y++) {
+        for (int x = 0; x < bench.width; x++) {
+            if (bench.map[y * bench.width + x] != 2) continue;
+            for (int d = 0; d < 4; d++) {
+                int nx = x + dx[d];
+                int ny = y + dy[d];
+                if (nx >= 0 && nx < bench.width && ny >= 0 && ny < bench.height &&
+                    bench.map[ny * bench.width + nx] == 0) {
+                    return CellCenter(nx, ny);
+                }
+            }
+        }
+    }
+    return bench.start;
+}
+
+static void AddBundledMaps(std::vector<BenchMap>& maps) {
+    for (int level = 1; level <= 5; level++) {
+        LevelData data;
+        BuildLevel(&data, level, 1, nullptr);
+        BenchMap bench;
+        bench.name = "worldMap" + std::to_string(level);
+        bench.level = level;
+        bench.map = data.map;
+        bench.width = data.mapWidth;
+        bench.height = data.mapHeight;
+        bench.start = NearestOpenCell(bench, data.playerStart);
+        bench.goal = FindDoorGoal(bench);
+        maps.push_back(bench);
+    }
+}
+
+static void AddMaze(std::vector<BenchMap>& maps, int size) {
+    maps.push_back(BenchMap());
+    BenchMap& bench = maps.back();
+    bench.name = "maze" + std::to_string(size);
+    bench.level = 0;
+    bench.width = size;
+    bench.height = size;
+    bench.storage.resize((size_t)size * size);
+    GenerateMaze(bench.storage.data(), size, size, 12345u);
+    bench.map = bench.storage.data();
+    bench.start = CellCenter(size / 2 | 1, size / 2 | 1);
+    bench.goal = FindDoorGoal(bench);
+}
+
+// One ray per screen column; other widths get the column count in the name
+static void BenchRaycast(const BenchMap& bench, int columns) {
+    std::vector<RayHit> hits(columns);
+    VisibleCellSet visible = {};
+    float angle = 0.0f;
+    std::string name = "raycast/" + bench.name;
+    if (columns != DEFAULT_SCREEN_WIDTH) name += "@" + std::to_string(columns);
+    RunBench(name, "rays", [&]() {
+        // Sweep the view around so every direction is covered
+        angle += 0.05f;
+        BeginVisibleCells(&visible);
+        benchSink = benchSink + CastRays(bench.start, angle, 60.0f * DEG2RAD, columns, hits.data(), &visible);
+        return (long long)columns;
+    });
+}
+
+static void BenchAStar(const BenchMap& bench) {
+    RunBench("astar/" + bench.name, "nodes", [&]() {
+        int nodesExpanded = 0;
+        std::vector<Vector2> path = FindPathAStar(bench.start, bench.goal, &nodesExpanded);
+        benchSink = benchSink + (long long)path.size();
+        return (long long)nodesExpanded;
+    });
+}
+
+static void BenchPlaceCollectibles(const BenchMap& bench) {
+    CollectibleStore store;
+    Rng rng;
+    SeedRng(&rng, 99);
+    if (bench.level > 0) {
+        RunBench("collectibles_init/" + bench.name, "items", [&]() {
+            InitCollectibles(store, bench.level, bench.start, &rng);
+            return (long long)store.count;
+        });
+    } else {
+        // Density similar to the bundled levels: about one coin per 16 cells
+        int coins = bench.width * bench.height / 16;
+        int boosts = coins / 20 + 1;
+        RunBench("collectibles_init/" + bench.name, "items", [&]() {
+            PlaceCollectibles(store, coins, boosts, bench.start, &rng);
+            return (long long)store.count;
+        });
+    }
+}
+
+static void BenchUpdateCollectibles(const BenchMap& bench) {
+    CollectibleStore store;
+    Rng rng;
+    SeedRng(&rng, 7);
+    if (bench.level > 0) {
+        InitCollectibles(store, bench.level, bench.start, &rng);
+    } else {
+        PlaceCollectibles(store, bench.width * bench.height / 16, 1, bench.start, &rng);
+    }
+    std::vector<unsigned long long> alive(store.alive.begin(), store.alive.end());
+    
+    // Query points on open cells; some land on items, most don't
+    const int queries = 1024;
+    std::vector<Vector2> points;
+    while ((int)points.size() < queries) {
+        int x = RngRange(&rng, bench.width);
+        int y = RngRange(&rng, bench.height);
+        if (GetMapTile(x, y) == 0) points.push_back({ x + RngFloat(&rng), y + RngFloat(&rng) });
+    }
+    
+    RunBench("collectibles_update/" + bench.name, "queries", [&]() {
+        int gold = 0;
+        bool boost = false;
+        float timer = 0.0f;
+        for (int i = 0; i < queries; i++) {
+            UpdateCollectibles(store, points[i], gold, boost, timer, 1.0f);
+        }
+        std::copy(alive.begin(), alive.end(), store.alive.begin());
+        benchSink = benchSink + gold;
+        return (long long)queries;
+    });
+}
+
+// Whole-game steps through the batch API, 4096 instances on every core
+static void BenchBatchSim(int level) {
+    BatchConfig config = DefaultBatchConfig();
+    config.instances = 4096;
+    config.level = level;
+    BatchSim sim;
+    InitBatchSim(&sim, config);
+    
+    // Wander: run forward and keep turning, changing direction now and then
+    std::vector<BatchAction> actions(config.instances);
+    Rng rng;
+    SeedRng(&rng, 5);
+    for (int i = 0; i < config.instances; i++) {
+        actions[i] = { 1.0f, 0.0f, RngFloat(&rng) * 0.2f - 0.1f };
+    }
+    int step = 0;
+    RunBench("batchsim/level" + std::to_string(level), "steps", [&]() {
+        if (++step % 64 == 0) {
+            for (int i = 0; i < config.instances; i++) actions[i].turn = RngFloat(&rng) * 0.2f - 0.1f;
+        }
+        StepBatchSim(&sim, actions.data());
+        return (long long)config.instances;
+    });
+    CloseBatchSim(&sim);
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minTime = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: benchmarks [--filter <text>] [--min-time <seconds>] [--json <file>]\n");
+            return 1;
+        }
+    }
+    SetTraceLogLevel(LOG_ERROR);
+    
+    std::vector<BenchMap> maps;
+    AddBundledMaps(maps);
+    AddMaze(maps, 257);
+    AddMaze(maps, 1025);
+    
+    printf("%-36s %12s %10s %12s %14s\n", "benchmark", "ns/op", "allocs/op", "bytes/op", "throughput");
+    for (size_t i = 0; i < maps.size(); i++) {
+        SetCurrentMap(maps[i].map, maps[i].width, maps[i].height);
+        BenchRaycast(maps[i], DEFAULT_SCREEN_WIDTH);
+        if (maps[i].level == 5) {
+            BenchRaycast(maps[i], 2560);
+            BenchRaycast(maps[i], 3840);
+        }
+        BenchAStar(maps[i]);
+        BenchPlaceCollectibles(maps[i]);
+        BenchUpdateCollectibles(maps[i]);
+    }
+    BenchBatchSim(1);
+    BenchBatchSim(5);
+    
+    if (options.jsonPath && !WriteJson(options.jsonPath)) return 1;
+    return 0;
+}
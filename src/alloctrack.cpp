@@ -0,0 +1,176 @@
+#include "alloctrack.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+// Only compiled with ALLOC_TRACKING (see CMakeLists.txt). Everything here
+// runs inside the allocator, so it must not allocate: counters are atomics
+// and plain thread_local arrays with no constructors.
+
+static std::atomic<unsigned long long> totalCount(0);
+static std::atomic<unsigned long long> totalBytes(0);
+static thread_local AllocCounts threadCounts[ALLOC_SLOTS];
+
+static void CountAllocation(size_t bytes) {
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+    AllocCounts& counts = threadCounts[profilePhase];
+    counts.count++;
+    counts.bytes += bytes;
+}
+
+AllocCounts GetAllocTotals() {
+    AllocCounts counts;
+    counts.count = totalCount.load(std::memory_order_relaxed);
+    counts.bytes = totalBytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+void TakeThreadAllocCounts(AllocCounts* counts) {
+    for (int i = 0; i < ALLOC_SLOTS; i++) {
+        counts[i] = threadCounts[i];
+        threadCounts[i].count = 0;
+        threadCounts[i].bytes = 0;
+    }
+}
+
+#if defined(__GLIBC__)
+// glibc exports its allocator under these names too, so we can wrap the
+// public ones and still reach the real thing. Everything glibc allocates with
+// can be given to free, so free itself isn't wrapped.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* p, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+    
+void* malloc(size_t size) {
+    CountAllocation(size);
+    return __libc_malloc(size);
+}
+    
+void* calloc(size_t count, size_t size) {
+    size_t bytes;
+    if (__builtin_mul_overflow(count, size, &bytes)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    CountAllocation(bytes);
+    return __libc_calloc(count, size);
+}
+    
+void* realloc(void* p, size_t size) {
+    CountAllocation(size);
+    return __libc_realloc(p, size);
+}
+    
+void* memalign(size_t alignment, size_t size) {
+    CountAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+    
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+    
+int posix_memalign(void** result, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* p = memalign(alignment, size);
+    if (p == NULL) return ENOMEM;
+    *result = p;
+    return 0;
+}
+}
+
+// malloc and memalign already count
+static void* TrackedAlloc(size_t size) {
+    return malloc(size ? size : 1);
+}
+
+static void* TrackedAlignedAlloc(size_t size, std::align_val_t alignment) {
+    return memalign((size_t)alignment, size ? size : 1);
+}
+#else
+// Elsewhere the C allocator isn't hooked, so only operator new counts, and
+// aligned operator new keeps the library's own (uncounted) version
+static void* TrackedAlloc(size_t size) {
+    CountAllocation(size);
+    return malloc(size ? size : 1);
+}
+#endif
+
+void* operator new(size_t size) {
+    void* p = TrackedAlloc(size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    void* p = TrackedAlloc(size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return TrackedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return TrackedAlloc(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+#if defined(__GLIBC__)
+// Over-aligned types (alignas beyond 16) come through these
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* p = TrackedAlignedAlloc(size, alignment);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    void* p = TrackedAlignedAlloc(size, alignment);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return TrackedAlignedAlloc(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return TrackedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    free(p);
+}
+#endif
@@ -0,0 +1,45 @@
+#ifndef ALLOCTRACK_H
+#define ALLOCTRACK_H
+
+#include "profiler.h"
+
+// Heap allocation tracker, built with -DALLOC_TRACKING=ON. Replaces global
+// operator new (and on glibc the aligned operator new, malloc, calloc,
+// realloc and the memalign family, which catches raylib's own allocations)
+// with versions that count calls and bytes. The thread's active profiler
+// phase gets the charge, PHASE_OTHER outside any scope. Without the option
+// these are no-ops and nothing is hooked.
+
+struct AllocCounts {
+    unsigned long long count;
+    unsigned long long bytes;
+};
+
+const int ALLOC_SLOTS = PHASE_OTHER + 1; // Per-phase counters, PHASE_OTHER last
+
+#ifdef ALLOC_TRACKING
+const bool allocTrackingBuilt = true;
+
+// Allocations on every thread since startup
+AllocCounts GetAllocTotals();
+
+// Move the calling thread's per-phase counts into counts[ALLOC_SLOTS] and
+// start them again from zero
+void TakeThreadAllocCounts(AllocCounts* counts);
+#else
+const bool allocTrackingBuilt = false;
+
+inline AllocCounts GetAllocTotals() {
+    AllocCounts counts = { 0, 0 };
+    return counts;
+}
+
+inline void TakeThreadAllocCounts(AllocCounts* counts) {
+    for (int i = 0; i < ALLOC_SLOTS; i++) {
+        counts[i].count = 0;
+        counts[i].bytes = 0;
+    }
+}
+#endif
+
+#endif
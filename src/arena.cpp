@@ -0,0 +1,101 @@
+#include "arena.h"
+#include <stdint.h>
+#include <algorithm>
+
+const size_t ARENA_MIN_BLOCK = 16 * 1024;
+
+struct alignas(16) ArenaBlock {
+    ArenaBlock* prev;
+    size_t size;   // Usable bytes after the header
+    size_t before; // Bytes used in the blocks behind this one
+};
+
+static unsigned char* BlockData(ArenaBlock* block) {
+    return (unsigned char*)(block + 1);
+}
+
+static ArenaBlock* NewBlock(ArenaBlock* prev, size_t size, size_t before) {
+    ArenaBlock* block = (ArenaBlock*)::operator new(sizeof(ArenaBlock) + size);
+    block->prev = prev;
+    block->size = size;
+    block->before = before;
+    return block;
+}
+
+Arena::~Arena() {
+    FreeArena(this);
+}
+
+void* ArenaAlloc(Arena* arena, size_t bytes, size_t align) {
+    ArenaBlock* head = arena->head;
+    uintptr_t p = 0;
+    if (head) {
+        p = ((uintptr_t)BlockData(head) + arena->used + align - 1) & ~(uintptr_t)(align - 1);
+    }
+    if (head == nullptr || p + bytes > (uintptr_t)BlockData(head) + head->size) {
+        // Grow geometrically so a long level costs few blocks
+        size_t size = std::max(ARENA_MIN_BLOCK, bytes + align);
+        if (head) size = std::max(size, head->size * 2);
+        size_t before = head ? head->before + arena->used : 0;
+        head = NewBlock(head, size, before);
+        arena->head = head;
+        arena->used = 0;
+        p = ((uintptr_t)BlockData(head) + align - 1) & ~(uintptr_t)(align - 1);
+    }
+    arena->used = (size_t)(p + bytes - (uintptr_t)BlockData(head));
+    arena->peak = std::max(arena->peak, head->before + arena->used);
+    return (void*)p;
+}
+
+ArenaMark GetArenaMark(const Arena* arena) {
+    ArenaMark mark;
+    mark.block = arena->head;
+    mark.used = arena->used;
+    return mark;
+}
+
+void RewindArena(Arena* arena, ArenaMark mark) {
+    while (arena->head != mark.block) {
+        ArenaBlock* prev = arena->head->prev;
+        ::operator delete(arena->head);
+        arena->head = prev;
+    }
+    arena->used = mark.used;
+    
+    // Empty again: if it took more than one block, swap for one that fits it all
+    bool empty = arena->head == nullptr || (arena->head->prev == nullptr && arena->used == 0);
+    if (empty && arena->peak > 0 && (arena->head == nullptr || arena->head->size < arena->peak)) {
+        ::operator delete(arena->head);
+        arena->head = NewBlock(nullptr, std::max(ARENA_MIN_BLOCK, arena->peak), 0);
+        arena->used = 0;
+    }
+}
+
+void ResetArena(Arena* arena) {
+    ArenaMark start = { nullptr, 0 };
+    if (arena->head) {
+        // Rewind to the start of the oldest block
+        ArenaBlock* first = arena->head;
+        while (first->prev) first = first->prev;
+        start.block = first;
+    }
+    RewindArena(arena, start);
+}
+
+void FreeArena(Arena* arena) {
+    while (arena->head) {
+        ArenaBlock* prev = arena->head->prev;
+        ::operator delete(arena->head);
+        arena->head = prev;
+    }
+    arena->used = 0;
+}
+
+size_t GetArenaUsed(const Arena* arena) {
+    return arena->head ? arena->head->before + arena->used : 0;
+}
+
+Arena* GetScratchArena() {
+    thread_local Arena scratch;
+    return &scratch;
+}
@@ -0,0 +1,109 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator: allocations are pointer increments into a chain of blocks
+// and are never freed one by one; the whole arena is rewound at once. A reset
+// keeps a single block as large as the most the arena ever held, so once it
+// has seen its biggest level (or frame) it stops calling malloc altogether.
+
+struct ArenaBlock;
+
+struct Arena {
+    ArenaBlock* head = nullptr; // Block being filled; older blocks chain behind it
+    size_t used = 0;            // Bytes used in head
+    size_t peak = 0;            // Most bytes ever in use, across all blocks
+    
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena();
+};
+
+// Position to rewind to; everything allocated after it goes at once
+struct ArenaMark {
+    ArenaBlock* block;
+    size_t used;
+};
+
+void* ArenaAlloc(Arena* arena, size_t bytes, size_t align);
+
+ArenaMark GetArenaMark(const Arena* arena);
+void RewindArena(Arena* arena, ArenaMark mark);
+
+// Drop everything (keeps one block sized for the peak)
+void ResetArena(Arena* arena);
+
+// Give every block back to the heap
+void FreeArena(Arena* arena);
+
+// Bytes currently allocated from the arena
+size_t GetArenaUsed(const Arena* arena);
+
+// This thread's scratch arena, for temporaries that die within a call
+Arena* GetScratchArena();
+
+// Rewinds an arena to where it was when the scope began. Containers using the
+// arena must be declared after the scope so they are destroyed before it.
+struct ArenaScope {
+    Arena* arena;
+    ArenaMark mark;
+    
+    explicit ArenaScope(Arena* arena) : arena(arena), mark(GetArenaMark(arena)) {}
+    ~ArenaScope() { RewindArena(arena, mark); }
+};
+
+// Standard allocator over an arena, for containers that hold arena data.
+// Deallocation is a no-op; a null arena falls back to the general heap, so
+// default-constructed containers behave like plain ones. The arena travels
+// with moves and swaps; copies go to the heap, since a copy may outlive it.
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type propagate_on_container_copy_assignment;
+    
+    Arena* arena;
+    
+    ArenaAllocator() : arena(nullptr) {}
+    explicit ArenaAllocator(Arena* arena) : arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+    
+    T* allocate(size_t n) {
+        if (arena) return (T*)ArenaAlloc(arena, n * sizeof(T), alignof(T));
+        return (T*)::operator new(n * sizeof(T));
+    }
+    void deallocate(T* p, size_t) {
+        if (!arena) ::operator delete(p);
+    }
+    ArenaAllocator select_on_container_copy_construction() const {
+        return ArenaAllocator();
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return a.arena != b.arena;
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Empty vector that will allocate from arena
+template <typename T>
+ArenaVector<T> MakeArenaVector(Arena* arena) {
+    return ArenaVector<T>(ArenaAllocator<T>(arena));
+}
+
+#endif
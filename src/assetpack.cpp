@@ -0,0 +1,156 @@
+#include "assetpack.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOGDI
+#define NOUSER
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Map the whole file read-only; pages are only faulted in when touched
+static bool MapFile(AssetPack* pack, const char* path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        CloseHandle(mapping);
+        return false;
+    }
+    pack->data = (const unsigned char*)view;
+    pack->size = (size_t)fileSize.QuadPart;
+    pack->mapping = mapping;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return false;
+    pack->data = (const unsigned char*)view;
+    pack->size = (size_t)info.st_size;
+    pack->mapping = NULL;
+#endif
+    return true;
+}
+
+// Decoded samples are handed straight to the audio device, so the format
+// must be one raylib plays and the frames must fit in the entry
+static bool IsPcmEntryValid(const AssetPackEntry* entry) {
+    unsigned int sampleSize = entry->sampleSize;
+    if (sampleSize != 8 && sampleSize != 16 && sampleSize != 32) return false;
+    if (entry->channels != 1 && entry->channels != 2) return false;
+    unsigned long long bytes = (unsigned long long)entry->frameCount * entry->channels * (sampleSize / 8);
+    return bytes <= entry->size;
+}
+
+bool OpenAssetPack(AssetPack* pack, const char* path) {
+    memset(pack, 0, sizeof(*pack));
+    if (!MapFile(pack, path)) {
+        TraceLog(LOG_WARNING, "Asset pack %s not found, using loose files", path);
+        return false;
+    }
+    
+    // Validate header and table of contents before trusting any offset
+    const AssetPackHeader* header = (const AssetPackHeader*)pack->data;
+    bool valid = pack->size >= sizeof(AssetPackHeader) &&
+                 memcmp(header->magic, ASSET_PACK_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == ASSET_PACK_VERSION &&
+                 header->tocOffset <= pack->size &&
+                 header->entryCount <= (pack->size - header->tocOffset) / sizeof(AssetPackEntry);
+    if (valid) {
+        const AssetPackEntry* entries = (const AssetPackEntry*)(pack->data + header->tocOffset);
+        for (unsigned int i = 0; i < header->entryCount && valid; i++) {
+            valid = entries[i].offset <= pack->size && entries[i].size <= pack->size - entries[i].offset &&
+                    memchr(entries[i].name, 0, ASSET_NAME_LENGTH) != NULL;
+            if (valid && entries[i].kind == ASSET_PCM) valid = IsPcmEntryValid(&entries[i]);
+        }
+    }
+    if (!valid) {
+        TraceLog(LOG_ERROR, "Asset pack %s is invalid", path);
+        CloseAssetPack(pack);
+        return false;
+    }
+    
+    pack->entries = (const AssetPackEntry*)(pack->data + header->tocOffset);
+    pack->entryCount = header->entryCount;
+    TraceLog(LOG_INFO, "Asset pack %s: %u entries, %u bytes", path, pack->entryCount, (unsigned int)pack->size);
+    return true;
+}
+
+void CloseAssetPack(AssetPack* pack) {
+    if (pack->data) {
+#ifdef _WIN32
+        UnmapViewOfFile(pack->data);
+        CloseHandle((HANDLE)pack->mapping);
+#else
+        munmap((void*)pack->data, pack->size);
+#endif
+    }
+    memset(pack, 0, sizeof(*pack));
+}
+
+const AssetPackEntry* FindAsset(const AssetPack* pack, const char* name) {
+    for (unsigned int i = 0; i < pack->entryCount; i++) {
+        if (strcmp(pack->entries[i].name, name) == 0) return &pack->entries[i];
+    }
+    return NULL;
+}
+
+Sound LoadPackedSound(const AssetPack* pack, const char* name) {
+    const AssetPackEntry* entry = FindAsset(pack, name);
+    if (entry == NULL) {
+        char path[256];
+        snprintf(path, sizeof(path), "assets/%s", name);
+        return LoadSound(path);
+    }
+    
+    const unsigned char* bytes = pack->data + entry->offset;
+    Wave wave;
+    if (entry->kind == ASSET_PCM) {
+        // Already decoded: the sound just copies the samples
+        wave.frameCount = entry->frameCount;
+        wave.sampleRate = entry->sampleRate;
+        wave.sampleSize = entry->sampleSize;
+        wave.channels = entry->channels;
+        wave.data = (void*)bytes;
+        return LoadSoundFromWave(wave);
+    }
+    
+    wave = LoadWaveFromMemory(GetFileExtension(name), bytes, (int)entry->size);
+    Sound sound = LoadSoundFromWave(wave);
+    UnloadWave(wave);
+    return sound;
+}
+
+Music LoadPackedMusic(const AssetPack* pack, const char* name) {
+    const AssetPackEntry* entry = FindAsset(pack, name);
+    if (entry == NULL) {
+        char path[256];
+        snprintf(path, sizeof(path), "assets/%s", name);
+        return LoadMusicStream(path);
+    }
+    
+    // Streams decode from the mapping, which lives as long as the pack
+    return LoadMusicStreamFromMemory(GetFileExtension(name), pack->data + entry->offset, (int)entry->size);
+}
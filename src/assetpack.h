@@ -0,0 +1,64 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <raylib.h>
+#include <stddef.h>
+
+// Packed asset archive (assets.pak), written by tools/assetpack.cpp at build
+// time. Layout: header, entry data (each entry ASSET_PACK_ALIGN aligned),
+// then the table of contents at tocOffset. All fields little-endian.
+
+#define ASSET_PACK_MAGIC "LD58PAK"
+const unsigned int ASSET_PACK_VERSION = 1;
+const unsigned int ASSET_PACK_ALIGN = 64;
+const int ASSET_NAME_LENGTH = 48;
+
+enum AssetKind {
+    ASSET_FILE = 0, // Original file bytes (decoded at load, e.g. music streams)
+    ASSET_PCM = 1   // Pre-decoded PCM samples, ready for LoadSoundFromWave
+};
+
+struct AssetPackHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int entryCount;
+    unsigned long long tocOffset;
+};
+
+struct AssetPackEntry {
+    char name[ASSET_NAME_LENGTH]; // File name, e.g. "collect.wav"
+    unsigned long long offset;
+    unsigned long long size;
+    unsigned int kind;
+    // PCM format (ASSET_PCM only)
+    unsigned int frameCount;
+    unsigned int sampleRate;
+    unsigned int sampleSize;
+    unsigned int channels;
+    unsigned int reserved;
+};
+
+// Read-only view of a memory-mapped pack. Entry data stays valid until
+// CloseAssetPack, so music can stream straight from it.
+struct AssetPack {
+    const unsigned char* data;
+    size_t size;
+    const AssetPackEntry* entries;
+    unsigned int entryCount;
+    void* mapping; // Platform mapping handle (Windows)
+};
+
+// Map a pack file. Returns false (pack left empty) if missing or invalid.
+bool OpenAssetPack(AssetPack* pack, const char* path);
+
+void CloseAssetPack(AssetPack* pack);
+
+// Entry by file name, or null
+const AssetPackEntry* FindAsset(const AssetPack* pack, const char* name);
+
+// Load a sound or music stream from the pack, falling back to the loose
+// file in assets/ if the pack is not open or lacks the entry
+Sound LoadPackedSound(const AssetPack* pack, const char* name);
+Music LoadPackedMusic(const AssetPack* pack, const char* name);
+
+#endif
@@ -0,0 +1,235 @@
+#include "audio.h"
+#include "assetpack.h"
+#include "trace.h"
+#include <raylib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+enum AudioEventType {
+    AUDIO_PLAY_SOUND,
+    AUDIO_STOP_SOUND,
+    AUDIO_LOOP_SOUND,
+    AUDIO_UNLOOP_SOUND,
+    AUDIO_PLAY_MUSIC,
+    AUDIO_RESTART_MUSIC,
+    AUDIO_STOP_MUSIC
+};
+
+struct AudioEvent {
+    int type;
+    int sound;
+};
+
+const unsigned int AUDIO_QUEUE_SIZE = 256; // Power of two
+const std::chrono::milliseconds AUDIO_UPDATE_INTERVAL(5); // Well under one music buffer
+
+// Single-producer single-consumer ring: only the game thread writes head,
+// only the audio thread writes tail. Indices run freely and are masked.
+struct AudioQueue {
+    AudioEvent events[AUDIO_QUEUE_SIZE];
+    std::atomic<unsigned int> head;
+    std::atomic<unsigned int> tail;
+};
+
+struct AudioSystem {
+    std::thread worker;
+    std::atomic<bool> running;
+    std::atomic<bool> ready;
+    AudioQueue queue;
+    unsigned int droppedEvents; // Game thread only
+    double deviceSeconds;       // Written before ready is set
+    double assetsSeconds;
+    
+    // Audio thread only
+    AssetPack pack;
+    Sound sounds[SOUND_COUNT];
+    bool looping[SOUND_COUNT];
+    Music music;
+};
+
+static AudioSystem audio;
+
+static const std::chrono::steady_clock::time_point startupTime = std::chrono::steady_clock::now();
+
+double GetStartupSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startupTime).count();
+}
+
+static bool PushAudioEvent(AudioQueue* queue, AudioEvent event) {
+    unsigned int head = queue->head.load(std::memory_order_relaxed);
+    if (head - queue->tail.load(std::memory_order_acquire) == AUDIO_QUEUE_SIZE) return false;
+    queue->events[head & (AUDIO_QUEUE_SIZE - 1)] = event;
+    queue->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+static bool PopAudioEvent(AudioQueue* queue, AudioEvent* event) {
+    unsigned int tail = queue->tail.load(std::memory_order_relaxed);
+    if (tail == queue->head.load(std::memory_order_acquire)) return false;
+    *event = queue->events[tail & (AUDIO_QUEUE_SIZE - 1)];
+    queue->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+static void PostAudioEvent(int type, int sound) {
+    if (!audio.running.load(std::memory_order_relaxed)) return;
+    
+    // Never block the game thread; a lost effect is better than a hitch
+    if (!PushAudioEvent(&audio.queue, { type, sound }) && audio.droppedEvents++ == 0) {
+        TraceLog(LOG_WARNING, "Audio queue full, dropping events");
+    }
+}
+
+static void LoadAudioAssets() {
+    const char* names[SOUND_COUNT] = { "collect.wav", "stab.wav", "purchase.wav", "jumpscare.wav" };
+    const float volumes[SOUND_COUNT] = { 0.5f, 0.7f, 0.6f, 0.2f };
+    
+    // One mapped archive instead of a file open per asset
+    OpenAssetPack(&audio.pack, "assets.pak");
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        audio.sounds[i] = LoadPackedSound(&audio.pack, names[i]);
+        if (!IsSoundReady(audio.sounds[i])) {
+            TraceLog(LOG_ERROR, "Failed to load %s", names[i]);
+        }
+        SetSoundVolume(audio.sounds[i], volumes[i]);
+        audio.looping[i] = false;
+    }
+    
+    audio.music = LoadPackedMusic(&audio.pack, "horror-music.mp3");
+    if (!IsMusicReady(audio.music)) {
+        TraceLog(LOG_ERROR, "Failed to load horror-music.mp3");
+    }
+    SetMusicVolume(audio.music, 0.4f);
+    audio.music.looping = true;
+}
+
+static void UnloadAudioAssets() {
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        if (IsSoundReady(audio.sounds[i])) {
+            UnloadSound(audio.sounds[i]);
+        }
+    }
+    if (IsMusicReady(audio.music)) {
+        StopMusicStream(audio.music);
+        UnloadMusicStream(audio.music);
+    }
+    CloseAssetPack(&audio.pack);
+}
+
+static void HandleAudioEvent(const AudioEvent& event) {
+    bool musicReady = IsMusicReady(audio.music);
+    switch (event.type) {
+        case AUDIO_PLAY_SOUND:
+            if (IsSoundReady(audio.sounds[event.sound])) PlaySound(audio.sounds[event.sound]);
+            break;
+        case AUDIO_STOP_SOUND:
+            if (IsSoundReady(audio.sounds[event.sound])) StopSound(audio.sounds[event.sound]);
+            break;
+        case AUDIO_LOOP_SOUND:
+            audio.looping[event.sound] = true;
+            break;
+        case AUDIO_UNLOOP_SOUND:
+            audio.looping[event.sound] = false;
+            if (IsSoundReady(audio.sounds[event.sound])) StopSound(audio.sounds[event.sound]);
+            break;
+        case AUDIO_PLAY_MUSIC:
+            if (musicReady && !IsMusicStreamPlaying(audio.music)) PlayMusicStream(audio.music);
+            break;
+        case AUDIO_RESTART_MUSIC:
+            if (musicReady) {
+                StopMusicStream(audio.music);
+                PlayMusicStream(audio.music);
+            }
+            break;
+        case AUDIO_STOP_MUSIC:
+            if (musicReady) StopMusicStream(audio.music);
+            break;
+    }
+}
+
+static void AudioThread() {
+    SetTraceThreadName("audio");
+    InitAudioDevice();
+    audio.deviceSeconds = GetStartupSeconds();
+    LoadAudioAssets();
+    audio.assetsSeconds = GetStartupSeconds();
+    audio.ready.store(true, std::memory_order_release);
+    
+    while (audio.running.load(std::memory_order_acquire)) {
+        AudioEvent event;
+        while (PopAudioEvent(&audio.queue, &event)) {
+            HandleAudioEvent(event);
+        }
+        
+        // Looping effects restart as soon as they finish
+        for (int i = 0; i < SOUND_COUNT; i++) {
+            if (audio.looping[i] && IsSoundReady(audio.sounds[i]) && !IsSoundPlaying(audio.sounds[i])) {
+                PlaySound(audio.sounds[i]);
+            }
+        }
+        
+        // Music decoding and buffer refill stay off the game thread
+        if (IsMusicReady(audio.music) && IsMusicStreamPlaying(audio.music)) {
+            TRACE_SCOPE("UpdateMusicStream");
+            UpdateMusicStream(audio.music);
+        }
+        
+        std::this_thread::sleep_for(AUDIO_UPDATE_INTERVAL);
+    }
+    
+    UnloadAudioAssets();
+    CloseAudioDevice();
+}
+
+void StartAudio() {
+    audio.queue.head.store(0);
+    audio.queue.tail.store(0);
+    audio.droppedEvents = 0;
+    audio.ready.store(false);
+    audio.running.store(true);
+    audio.worker = std::thread(AudioThread);
+}
+
+void StopAudio() {
+    if (!audio.worker.joinable()) return;
+    audio.running.store(false, std::memory_order_release);
+    audio.worker.join();
+    audio.ready.store(false);
+}
+
+bool IsAudioReady() {
+    return audio.ready.load(std::memory_order_acquire);
+}
+
+void GetAudioStartupTimes(double* deviceSeconds, double* assetsSeconds) {
+    bool ready = IsAudioReady();
+    *deviceSeconds = ready ? audio.deviceSeconds : 0.0;
+    *assetsSeconds = ready ? audio.assetsSeconds : 0.0;
+}
+
+void PlayGameSound(GameSound sound) {
+    if (!IsAudioReady()) return;
+    PostAudioEvent(AUDIO_PLAY_SOUND, sound);
+}
+
+void StopGameSound(GameSound sound) {
+    if (!IsAudioReady()) return;
+    PostAudioEvent(AUDIO_STOP_SOUND, sound);
+}
+
+void LoopGameSound(GameSound sound, bool looping) {
+    PostAudioEvent(looping ? AUDIO_LOOP_SOUND : AUDIO_UNLOOP_SOUND, sound);
+}
+
+void PlayGameMusic() {
+    PostAudioEvent(AUDIO_PLAY_MUSIC, 0);
+}
+
+void RestartGameMusic() {
+    PostAudioEvent(AUDIO_RESTART_MUSIC, 0);
+}
+
+void StopGameMusic() {
+    PostAudioEvent(AUDIO_STOP_MUSIC, 0);
+}
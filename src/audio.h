@@ -0,0 +1,46 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+// Audio runs on its own thread: it opens the device, decodes the assets,
+// keeps the music stream refilled and plays sound effects. The game thread
+// only posts events to it through a lock-free single-producer queue, so a
+// slow frame never starves the music decoder.
+
+enum GameSound {
+    SOUND_COLLECT,
+    SOUND_STAB,
+    SOUND_PURCHASE,
+    SOUND_JUMPSCARE,
+    SOUND_COUNT
+};
+
+// Start the audio thread (device init and asset loading happen on it)
+void StartAudio();
+
+// Stop the audio thread, unload everything and close the device
+void StopAudio();
+
+// True once the device is up and assets are loaded
+bool IsAudioReady();
+
+// Startup timeline: seconds since process start when the device was up
+// and when all assets were loaded (0 until then)
+void GetAudioStartupTimes(double* deviceSeconds, double* assetsSeconds);
+
+// Seconds since the process started
+double GetStartupSeconds();
+
+// Sound effects. Posted from the game thread only; dropped until the audio
+// is ready, like the old IsSoundReady checks.
+void PlayGameSound(GameSound sound);
+void StopGameSound(GameSound sound);
+
+// Keep restarting sound whenever it finishes, until turned off
+void LoopGameSound(GameSound sound, bool looping);
+
+// Music: play if not already playing, restart from the top, or stop
+void PlayGameMusic();
+void RestartGameMusic();
+void StopGameMusic();
+
+#endif
@@ -0,0 +1,259 @@
+#include "batchsim.h"
+#include "map.h"
+#include "raycaster.h"
+#include "trace.h"
+#include <cmath>
+#include <algorithm>
+
+enum BatchJob {
+    JOB_RESET,
+    JOB_STEP
+};
+
+BatchConfig DefaultBatchConfig() {
+    BatchConfig config;
+    config.instances = 1024;
+    config.threads = 0;
+    config.level = 1;
+    config.ticksPerStep = 4;
+    config.maxEpisodeSteps = 3600; // Two minutes of play
+    config.depthColumns = 64;
+    config.gridWidth = MAP_WIDTH_2;
+    config.gridHeight = MAP_HEIGHT_2;
+    config.seed = 1;
+    config.doorCostScale = 1.0f;
+    config.enemySpeed = 0.0f;
+    config.goldMultiplier = 1.0f;
+    config.playerSpeed = 3.0f;
+    config.goldReward = 0.01f;
+    config.exitReward = 1.0f;
+    config.deathPenalty = 1.0f;
+    return config;
+}
+
+static void WriteObservation(BatchSim* sim, int i) {
+    const BatchConfig& config = sim->config;
+    const GameState* game = &sim->games[i];
+    Vector2 pos = game->player.position;
+    
+    // Depth: the same rays the renderer casts, at observation resolution
+    thread_local std::vector<RayHit> hits;
+    hits.resize(config.depthColumns);
+    CastRays(pos, game->player.angle, game->FOV, config.depthColumns, hits.data(), nullptr);
+    float* depth = &sim->depth[(size_t)i * config.depthColumns];
+    for (int x = 0; x < config.depthColumns; x++) {
+        depth[x] = hits[x].distance;
+    }
+    
+    // Minimap: tiles, then items, enemy and player on top
+    unsigned char* grid = &sim->grid[(size_t)i * config.gridWidth * config.gridHeight];
+    MapView map = GetCurrentMapView();
+    for (int y = 0; y < config.gridHeight; y++) {
+        for (int x = 0; x < config.gridWidth; x++) {
+            int tile = GetMapTile(map, x, y);
+            grid[y * config.gridWidth + x] = tile == 2 ? BATCH_CELL_DOOR : tile != 0 ? BATCH_CELL_WALL : BATCH_CELL_EMPTY;
+        }
+    }
+    const CollectibleStore& store = game->collectibles;
+    for (int item = 0; item < store.count; item++) {
+        if (!(store.alive[item >> 6] >> (item & 63) & 1)) continue;
+        int x = (int)store.x[item];
+        int y = (int)store.y[item];
+        if (x < 0 || x >= config.gridWidth || y < 0 || y >= config.gridHeight) continue;
+        grid[y * config.gridWidth + x] = store.type[item] == BOOST ? BATCH_CELL_BOOST : BATCH_CELL_COIN;
+    }
+    Vector2 enemyPos = game->enemy.position;
+    if (game->enemy.isActive && enemyPos.x >= 0 && (int)enemyPos.x < config.gridWidth &&
+        enemyPos.y >= 0 && (int)enemyPos.y < config.gridHeight) {
+        grid[(int)enemyPos.y * config.gridWidth + (int)enemyPos.x] = BATCH_CELL_ENEMY;
+    }
+    if ((int)pos.x < config.gridWidth && (int)pos.y < config.gridHeight) {
+        grid[(int)pos.y * config.gridWidth + (int)pos.x] = BATCH_CELL_PLAYER;
+    }
+    
+    float* state = &sim->state[(size_t)i * BATCH_STATE_SIZE];
+    state[0] = pos.x;
+    state[1] = pos.y;
+    state[2] = cosf(game->player.angle);
+    state[3] = sinf(game->player.angle);
+    state[4] = (float)game->totalGold;
+    state[5] = (float)game->doorCost;
+    state[6] = game->player.boostTimer;
+    state[7] = game->enemy.isActive ? sqrtf((enemyPos.x - pos.x) * (enemyPos.x - pos.x) +
+                                            (enemyPos.y - pos.y) * (enemyPos.y - pos.y)) : 0.0f;
+}
+
+// New episode on the configured level, with the tuning overrides applied
+static void ResetInstance(BatchSim* sim, int i) {
+    const BatchConfig& config = sim->config;
+    GameState* game = &sim->games[i];
+    CancelLevelLoad(&game->loader);
+    InitGame(game);
+    game->player.goldMultiplier = config.goldMultiplier;
+    game->player.baseSpeed = config.playerSpeed;
+    game->player.moveSpeed = config.playerSpeed;
+    InitLevel(game, config.level);
+    game->doorCost = std::max(1, (int)lroundf(game->doorCost * config.doorCostScale));
+    if (config.enemySpeed > 0.0f) game->enemy.speed = config.enemySpeed;
+    
+    // InitLevel made the level this thread's current map
+    BatchInstance* instance = &sim->instances[i];
+    instance->map = currentMap;
+    instance->mapWidth = currentMapWidth;
+    instance->mapHeight = currentMapHeight;
+    instance->episodeSteps = 0;
+}
+
+static void StepInstance(BatchSim* sim, int i, const BatchAction& action) {
+    const BatchConfig& config = sim->config;
+    GameState* game = &sim->games[i];
+    BatchInstance* instance = &sim->instances[i];
+    SetCurrentMap(instance->map, instance->mapWidth, instance->mapHeight);
+    
+    GameInput input = {};
+    input.moveForward = action.forward > 0.0f;
+    input.moveBack = action.forward < 0.0f;
+    input.moveRight = action.strafe > 0.0f;
+    input.moveLeft = action.strafe < 0.0f;
+    float lookPerTick = action.turn / (config.ticksPerStep * game->player.mouseSensitivity);
+    
+    int goldBefore = game->totalGold;
+    for (int tick = 0; tick < config.ticksPerStep && game->mode == PLAYING; tick++) {
+        input.lookDelta = lookPerTick;
+        UpdateGame(game, &input, SIM_DT);
+    }
+    instance->episodeSteps++;
+    
+    float reward = (game->totalGold - goldBefore) * config.goldReward;
+    // Leaving through the door moves on a level, whether the shop, the
+    // loading screen or the won screen comes next
+    bool won = game->currentLevel > config.level;
+    bool lost = game->mode == GAME_LOST;
+    bool truncated = config.maxEpisodeSteps > 0 && instance->episodeSteps >= config.maxEpisodeSteps;
+    if (won) reward += config.exitReward;
+    if (lost) reward -= config.deathPenalty;
+    
+    sim->rewards[i] = reward;
+    sim->wins[i] = won;
+    sim->dones[i] = won || lost || truncated;
+    if (sim->dones[i]) ResetInstance(sim, i);
+    WriteObservation(sim, i);
+}
+
+static void RunSlice(BatchSim* sim, int slice, int job, const BatchAction* actions) {
+    int threadCount = (int)sim->workers.size() + 1;
+    int begin = (int)((long long)sim->config.instances * slice / threadCount);
+    int end = (int)((long long)sim->config.instances * (slice + 1) / threadCount);
+    for (int i = begin; i < end; i++) {
+        if (job == JOB_RESET) {
+            ResetInstance(sim, i);
+            WriteObservation(sim, i);
+        } else {
+            StepInstance(sim, i, actions[i]);
+        }
+    }
+}
+
+static void WorkerMain(BatchSim* sim, int slice) {
+    SetTraceThreadName("batch worker");
+    unsigned long long seen = 0;
+    for (;;) {
+        int job;
+        const BatchAction* actions;
+        {
+            std::unique_lock<std::mutex> lock(sim->mutex);
+            sim->jobReady.wait(lock, [&]() { return sim->quit || sim->jobGeneration != seen; });
+            if (sim->quit) return;
+            seen = sim->jobGeneration;
+            job = sim->jobType;
+            actions = sim->jobActions;
+        }
+        
+        RunSlice(sim, slice, job, actions);
+        
+        std::lock_guard<std::mutex> lock(sim->mutex);
+        if (--sim->jobPending == 0) sim->jobDone.notify_one();
+    }
+}
+
+// Run job on every slice and wait for all of them
+static void RunJob(BatchSim* sim, int job, const BatchAction* actions) {
+    {
+        std::lock_guard<std::mutex> lock(sim->mutex);
+        sim->jobType = job;
+        sim->jobActions = actions;
+        sim->jobPending = (int)sim->workers.size();
+        sim->jobGeneration++;
+    }
+    sim->jobReady.notify_all();
+    
+    RunSlice(sim, 0, job, actions);
+    
+    std::unique_lock<std::mutex> lock(sim->mutex);
+    sim->jobDone.wait(lock, [&]() { return sim->jobPending == 0; });
+}
+
+void InitBatchSim(BatchSim* sim, const BatchConfig& config) {
+    sim->config = config;
+    sim->config.level = std::min(std::max(config.level, 1), MAX_LEVELS);
+    sim->config.ticksPerStep = std::max(config.ticksPerStep, 1);
+    int n = config.instances;
+    
+    sim->games = new GameState[n]();
+    sim->instances.assign(n, BatchInstance());
+    sim->depth.assign((size_t)n * config.depthColumns, 0.0f);
+    sim->grid.assign((size_t)n * config.gridWidth * config.gridHeight, 0);
+    sim->state.assign((size_t)n * BATCH_STATE_SIZE, 0.0f);
+    sim->rewards.assign(n, 0.0f);
+    sim->dones.assign(n, 0);
+    sim->wins.assign(n, 0);
+    
+    // Every instance gets its own stream, so results don't depend on the
+    // thread count or on which thread runs which instance
+    for (int i = 0; i < n; i++) {
+        SeedRng(&sim->games[i].rng, config.seed * 0x9E3779B9u + (unsigned int)i);
+        sim->games[i].foregroundLoads = true; // Episodes end at the door, so the next level is never played
+    }
+    
+    int threadCount = config.threads > 0 ? config.threads : (int)std::thread::hardware_concurrency();
+    threadCount = std::max(1, std::min(threadCount, n));
+    sim->jobGeneration = 0;
+    sim->jobPending = 0;
+    sim->jobType = JOB_RESET;
+    sim->jobActions = nullptr;
+    sim->quit = false;
+    for (int t = 1; t < threadCount; t++) {
+        sim->workers.push_back(std::thread(WorkerMain, sim, t));
+    }
+    
+    ResetBatchSim(sim);
+}
+
+void ResetBatchSim(BatchSim* sim) {
+    RunJob(sim, JOB_RESET, nullptr);
+    std::fill(sim->rewards.begin(), sim->rewards.end(), 0.0f);
+    std::fill(sim->dones.begin(), sim->dones.end(), 0);
+    std::fill(sim->wins.begin(), sim->wins.end(), 0);
+}
+
+void StepBatchSim(BatchSim* sim, const BatchAction* actions) {
+    RunJob(sim, JOB_STEP, actions);
+}
+
+void CloseBatchSim(BatchSim* sim) {
+    {
+        std::lock_guard<std::mutex> lock(sim->mutex);
+        sim->quit = true;
+    }
+    sim->jobReady.notify_all();
+    for (size_t t = 0; t < sim->workers.size(); t++) {
+        sim->workers[t].join();
+    }
+    sim->workers.clear();
+    
+    for (int i = 0; i < sim->config.instances; i++) {
+        CancelLevelLoad(&sim->games[i].loader);
+    }
+    delete[] sim->games;
+    sim->games = nullptr;
+}
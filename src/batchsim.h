@@ -0,0 +1,110 @@
+#ifndef BATCHSIM_H
+#define BATCHSIM_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "game.h"
+
+// Headless batch simulation: many independent games stepped in lockstep on a
+// worker pool, for tuning door costs, perks and enemy speed by automated play.
+// No window or audio is needed. Each instance plays one level per episode and
+// is reset automatically when the episode ends.
+
+// One step's controls for one instance
+struct BatchAction {
+    float forward; // > 0 forward, < 0 back
+    float strafe;  // > 0 right, < 0 left
+    float turn;    // Radians to turn over the step
+};
+
+// Minimap observation cell values
+enum BatchCell {
+    BATCH_CELL_EMPTY,
+    BATCH_CELL_WALL,
+    BATCH_CELL_DOOR,
+    BATCH_CELL_COIN,
+    BATCH_CELL_BOOST,
+    BATCH_CELL_ENEMY,
+    BATCH_CELL_PLAYER
+};
+
+// Per-instance state vector: x, y, cos(angle), sin(angle), gold, door cost,
+// boost time left, distance to the enemy
+const int BATCH_STATE_SIZE = 8;
+
+struct BatchConfig {
+    int instances;
+    int threads;          // Worker threads including the caller, 0 = one per core
+    int level;            // Level every episode plays (1..MAX_LEVELS)
+    int ticksPerStep;     // Fixed simulation ticks per step
+    int maxEpisodeSteps;  // Episodes are cut off after this many steps, 0 = never
+    int depthColumns;     // Width of the depth observation
+    int gridWidth;        // Minimap observation size; maps are padded with walls
+    int gridHeight;
+    unsigned int seed;
+    
+    // Tuning overrides, applied at every reset
+    float doorCostScale;  // Multiplies the level's door cost
+    float enemySpeed;     // 0 keeps the level's speed
+    float goldMultiplier; // Player perks: gold multiplier and base speed
+    float playerSpeed;
+    
+    // Reward shaping
+    float goldReward;     // Per gold collected
+    float exitReward;     // Leaving through the door
+    float deathPenalty;   // Subtracted when caught
+};
+
+// Defaults: level 1, 64 depth columns, 20x20 grid, 4 ticks (1/30 s) per step
+BatchConfig DefaultBatchConfig();
+
+struct BatchInstance {
+    const int* map; // Level map, made current before the instance runs
+    int mapWidth;
+    int mapHeight;
+    int episodeSteps;
+};
+
+struct BatchSim {
+    BatchConfig config;
+    GameState* games;
+    std::vector<BatchInstance> instances;
+    
+    // Observation and result tensors, instance-major and allocated once.
+    // After a step that ended an episode they already show the next one.
+    std::vector<float> depth;          // instances * depthColumns, wall distance per column
+    std::vector<unsigned char> grid;   // instances * gridHeight * gridWidth, BatchCell values
+    std::vector<float> state;          // instances * BATCH_STATE_SIZE
+    std::vector<float> rewards;        // instances
+    std::vector<unsigned char> dones;  // instances, 1 if the episode ended this step
+    std::vector<unsigned char> wins;   // instances, 1 if it ended at the door
+    
+    // Worker pool. Thread t runs its own contiguous slice of instances every
+    // job; the caller runs slice 0 and waits for the rest.
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+    unsigned long long jobGeneration;
+    int jobPending;
+    int jobType;
+    const BatchAction* jobActions;
+    bool quit;
+};
+
+// Allocate the tensors, start the workers and reset every instance
+void InitBatchSim(BatchSim* sim, const BatchConfig& config);
+
+// Start a new episode on every instance
+void ResetBatchSim(BatchSim* sim);
+
+// Advance every instance by one step with actions[instances]. The calling
+// thread runs a slice too, so its current map is changed.
+void StepBatchSim(BatchSim* sim, const BatchAction* actions);
+
+// Stop the workers and free the instances
+void CloseBatchSim(BatchSim* sim);
+
+#endif
@@ -1,225 +1,501 @@
 #include "collectible.h"
 #include "map.h"
+#include "rng.h"
+#include "arena.h"
 #include <raymath.h>
 #include <cmath>
 #include <stdlib.h>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-std::vector<Collectible> InitCollectibles(int level) {
-    std::vector<Collectible> collectibles;
+struct PlacedItem {
+    Vector2 pos;
+    float value;
+    int type;
+};
+
+// Fill the store from placed items, sorted by map cell (counting sort)
+static void BuildCollectibleStore(CollectibleStore& store, const ArenaVector<PlacedItem>& placed) {
+    int itemCount = (int)placed.size();
+    int cellCount = currentMapWidth * currentMapHeight;
     
-    // Generate random collectible positions, ensuring they're not in walls
-    int numCoins;
-    if (level == 1) {
-        numCoins = 5; // Exactly 5 coins in level 1 (5 * 10 = 50 gold for door)
-    } else {
-        numCoins = 15 + (rand() % 10); // 15-25 coins in other levels
+    store.count = itemCount;
+    store.gridWidth = currentMapWidth;
+    store.gridHeight = currentMapHeight;
+    store.cellStart.assign(cellCount + 1, 0);
+    store.x.resize(itemCount);
+    store.y.resize(itemCount);
+    store.value.resize(itemCount);
+    store.type.resize(itemCount);
+    
+    for (const PlacedItem& item : placed) {
+        store.cellStart[(int)item.pos.y * store.gridWidth + (int)item.pos.x + 1]++;
+    }
+    for (int c = 0; c < cellCount; c++) {
+        store.cellStart[c + 1] += store.cellStart[c];
     }
-    int attempts = 0;
-    int maxAttempts = numCoins * 10;
     
-    while (collectibles.size() < (size_t)numCoins && attempts < maxAttempts) {
-        attempts++;
-        
-        float x = 2.0f + (float)(rand() % (currentMapWidth - 4));
-        float y = 2.0f + (float)(rand() % (currentMapHeight - 4));
-        
-        // Check if position is walkable and not a door
-        int mapX = (int)x;
-        int mapY = (int)y;
-        
-        if (GetMapTile(mapX, mapY) != 0) continue;
-        
-        // Check if too close to other collectibles
-        bool tooClose = false;
-        for (const auto& c : collectibles) {
-            float dx = c.pos.x - x;
-            float dy = c.pos.y - y;
-            if (dx*dx + dy*dy < 4.0f) { // At least 2 units apart
-                tooClose = true;
-                break;
+    ArenaVector<int> cursor(store.cellStart.begin(), store.cellStart.end() - 1, ArenaAllocator<int>(GetScratchArena()));
+    for (const PlacedItem& item : placed) {
+        int slot = cursor[(int)item.pos.y * store.gridWidth + (int)item.pos.x]++;
+        store.x[slot] = item.pos.x;
+        store.y[slot] = item.pos.y;
+        store.value[slot] = item.value;
+        store.type[slot] = (unsigned char)item.type;
+    }
+    
+    // All alive; bits past count stay clear
+    store.alive.assign((itemCount + 63) / 64, ~0ULL);
+    if (itemCount % 64) {
+        store.alive.back() = (1ULL << (itemCount % 64)) - 1;
+    }
+}
+
+// Index of the lowest set bit (bits must be non-zero)
+static int LowestBit(unsigned long long bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+static bool IsAlive(const CollectibleStore& store, int item) {
+    return (store.alive[item >> 6] >> (item & 63)) & 1;
+}
+
+// Up to 32 alive bits starting at item
+static unsigned int AliveBits(const CollectibleStore& store, int item) {
+    int word = item >> 6;
+    int shift = item & 63;
+    unsigned long long bits = store.alive[word] >> shift;
+    if (shift > 32 && word + 1 < (int)store.alive.size()) {
+        bits |= store.alive[word + 1] << (64 - shift);
+    }
+    return (unsigned int)bits;
+}
+
+// Background grid for Poisson-disk sampling. Cell size is spacing / sqrt(2),
+// so a slot holds at most one point and a radius query checks a few slots.
+struct SampleGrid {
+    float spacing;
+    float cellSize;
+    int width;
+    int height;
+    ArenaVector<Vector2> points;
+    ArenaVector<int> slots; // Index into points, -1 if empty
+};
+
+static const float COIN_SPACING = 2.0f;   // Coins at least 2 units apart
+static const float BOOST_SPACING = 3.0f;  // Boosts at least 3 units from everything
+static const int SAMPLE_ATTEMPTS = 30;    // Bridson candidates per active point
+static const int CELL_ATTEMPTS = 4;       // Dart-throwing candidates per map cell
+
+static void InitSampleGrid(SampleGrid& grid, float spacing, int mapWidth, int mapHeight, int capacity) {
+    grid.points = MakeArenaVector<Vector2>(GetScratchArena());
+    grid.slots = MakeArenaVector<int>(GetScratchArena());
+    grid.spacing = spacing;
+    grid.cellSize = spacing / sqrtf(2.0f);
+    grid.width = (int)ceilf(mapWidth / grid.cellSize);
+    grid.height = (int)ceilf(mapHeight / grid.cellSize);
+    grid.points.clear();
+    grid.points.reserve(capacity);
+    grid.slots.assign((size_t)grid.width * grid.height, -1);
+}
+
+// True if no point of the grid lies within radius of p
+static bool IsFarFromSamples(const SampleGrid& grid, Vector2 p, float radius) {
+    int gx = (int)(p.x / grid.cellSize);
+    int gy = (int)(p.y / grid.cellSize);
+    if (gx >= grid.width) gx = grid.width - 1;
+    if (gy >= grid.height) gy = grid.height - 1;
+    
+    // An occupied own slot is always too close
+    if (radius >= grid.spacing && grid.slots[gy * grid.width + gx] >= 0) return false;
+    
+    int reach = (int)ceilf(radius / grid.cellSize);
+    float radiusSq = radius * radius;
+    for (int y = gy - reach; y <= gy + reach; y++) {
+        if (y < 0 || y >= grid.height) continue;
+        for (int x = gx - reach; x <= gx + reach; x++) {
+            if (x < 0 || x >= grid.width) continue;
+            int index = grid.slots[y * grid.width + x];
+            if (index < 0) continue;
+            float dx = grid.points[index].x - p.x;
+            float dy = grid.points[index].y - p.y;
+            if (dx * dx + dy * dy < radiusSq) return false;
+        }
+    }
+    return true;
+}
+
+static void InsertSample(SampleGrid& grid, Vector2 p) {
+    int gx = (int)(p.x / grid.cellSize);
+    int gy = (int)(p.y / grid.cellSize);
+    if (gx >= grid.width) gx = grid.width - 1;
+    if (gy >= grid.height) gy = grid.height - 1;
+    grid.slots[gy * grid.width + gx] = (int)grid.points.size();
+    grid.points.push_back(p);
+}
+
+// Coins keep 2 units from coins and 3 from boosts; boosts keep 3 from everything
+static bool TryAddSample(SampleGrid& target, const SampleGrid& other, Vector2 p) {
+    float otherRadius = BOOST_SPACING;
+    if (!IsFarFromSamples(target, p, target.spacing)) return false;
+    if (!IsFarFromSamples(other, p, otherRadius)) return false;
+    InsertSample(target, p);
+    return true;
+}
+
+// Flood fill (4-connected) over floor tiles from start. Marks reachable cells
+// and returns them in visit order.
+static ArenaVector<int> FindReachableCells(const MapView& map, Vector2 start, ArenaVector<unsigned char>& reachable) {
+    ArenaVector<int> cells = MakeArenaVector<int>(GetScratchArena());
+    int width = map.width;
+    int height = map.height;
+    reachable.assign((size_t)width * height, 0);
+    int startX = (int)start.x;
+    int startY = (int)start.y;
+    
+    // Some level starts sit inside a wall tile; use the nearest floor tile
+    for (int ring = 1; GetMapTile(map, startX, startY) != 0; ring++) {
+        if (ring > width && ring > height) return cells;
+        bool found = false;
+        for (int y = (int)start.y - ring; y <= (int)start.y + ring && !found; y++) {
+            for (int x = (int)start.x - ring; x <= (int)start.x + ring && !found; x++) {
+                if (GetMapTile(map, x, y) == 0) {
+                    startX = x;
+                    startY = y;
+                    found = true;
+                }
             }
         }
-        
-        if (tooClose) continue;
-        
-        collectibles.push_back({{x, y}, false, 10, COIN});
     }
     
-    // Add 1-2 speed boosts in safe locations (not in level 1)
-    int numBoosts = (level == 1) ? 0 : 1 + (rand() % 2);
-    attempts = 0;
-    int boostsAdded = 0;
+    cells.push_back(startY * width + startX);
+    reachable[cells[0]] = 1;
     
-    while (boostsAdded < numBoosts && attempts < 100) {
-        attempts++;
-        
-        float x = 3.0f + (float)(rand() % (currentMapWidth - 6));
-        float y = 3.0f + (float)(rand() % (currentMapHeight - 6));
-        
-        int mapX = (int)x;
-        int mapY = (int)y;
-        
-        if (GetMapTile(mapX, mapY) != 0) continue;
-        
-        // Check if too close to other collectibles
-        bool tooClose = false;
-        for (const auto& c : collectibles) {
-            float dx = c.pos.x - x;
-            float dy = c.pos.y - y;
-            if (dx*dx + dy*dy < 9.0f) { // At least 3 units apart
-                tooClose = true;
-                break;
-            }
+    for (size_t head = 0; head < cells.size(); head++) {
+        int cell = cells[head];
+        int x = cell % width;
+        int y = cell / width;
+        int next[4];
+        int nextCount = 0;
+        if (y > 0) next[nextCount++] = cell - width;
+        if (x < width - 1) next[nextCount++] = cell + 1;
+        if (y < height - 1) next[nextCount++] = cell + width;
+        if (x > 0) next[nextCount++] = cell - 1;
+        for (int i = 0; i < nextCount; i++) {
+            int n = next[i];
+            if (reachable[n] || map.tiles[n] != 0) continue;
+            reachable[n] = 1;
+            cells.push_back(n);
+        }
+    }
+    return cells;
+}
+
+static bool IsInCandidateCell(const MapView& map, const ArenaVector<unsigned char>& reachable, Vector2 p, int margin) {
+    if (p.x < 0.0f || p.y < 0.0f) return false;
+    int x = (int)p.x;
+    int y = (int)p.y;
+    if (x < margin || x >= map.width - margin || y < margin || y >= map.height - margin) return false;
+    return reachable[y * map.width + x] != 0;
+}
+
+// Dart throwing over map cells in random order. The shuffle is incremental
+// (Fisher-Yates one step per visited cell), so small counts stay cheap on
+// big maps; points spread over the whole area and we stop at count.
+static void SampleByCellSweep(const MapView& map, SampleGrid& target, const SampleGrid& other,
+                              ArenaVector<int>& cells, const ArenaVector<unsigned char>& reachable, int margin,
+                              size_t count, Rng* rng) {
+    int cellCount = (int)cells.size();
+    for (int i = 0; i < cellCount && target.points.size() < count; i++) {
+        std::swap(cells[i], cells[i + RngRange(rng, cellCount - i)]);
+        float cellX = (float)(cells[i] % map.width);
+        float cellY = (float)(cells[i] / map.width);
+        if (!IsInCandidateCell(map, reachable, {cellX, cellY}, margin)) continue;
+        
+        for (int attempt = 0; attempt < CELL_ATTEMPTS; attempt++) {
+            Vector2 p = { cellX + RngFloat(rng), cellY + RngFloat(rng) };
+            if (TryAddSample(target, other, p)) break;
+        }
+    }
+}
+
+// Bridson growth from the existing points into the gaps the sweep left,
+// until count is reached or the set is maximal
+static void SampleBridson(const MapView& map, SampleGrid& target, const SampleGrid& other,
+                          const ArenaVector<unsigned char>& reachable, int margin, size_t count, Rng* rng) {
+    ArenaVector<int> active = MakeArenaVector<int>(GetScratchArena());
+    for (int i = 0; i < (int)target.points.size(); i++) {
+        active.push_back(i);
+    }
+    
+    while (!active.empty() && target.points.size() < count) {
+        int activeIndex = RngRange(rng, (int)active.size());
+        Vector2 origin = target.points[active[activeIndex]];
+        bool found = false;
+        
+        for (int attempt = 0; attempt < SAMPLE_ATTEMPTS; attempt++) {
+            float angle = RngFloat(rng) * 2.0f * PI;
+            float dist = target.spacing * (1.0f + RngFloat(rng));
+            Vector2 p = { origin.x + cosf(angle) * dist, origin.y + sinf(angle) * dist };
+            if (!IsInCandidateCell(map, reachable, p, margin)) continue;
+            if (!TryAddSample(target, other, p)) continue;
+            active.push_back((int)target.points.size() - 1);
+            found = true;
+            break;
         }
         
-        if (tooClose) continue;
-        
-        collectibles.push_back({{x, y}, false, 0, BOOST});
-        boostsAdded++;
+        if (!found) {
+            active[activeIndex] = active.back();
+            active.pop_back();
+        }
+    }
+}
+
+void PlaceCollectibles(CollectibleStore& store, int numCoins, int numBoosts, Vector2 startPos, Rng* rng) {
+    // Placement temporaries live in this thread's scratch arena and go in
+    // one rewind when we return
+    ArenaScope scratch(GetScratchArena());
+    
+    // Only cells the player can actually walk to are candidates
+    ArenaVector<unsigned char> reachable = MakeArenaVector<unsigned char>(scratch.arena);
+    MapView map = GetCurrentMapView();
+    ArenaVector<int> cells = FindReachableCells(map, startPos, reachable);
+    
+    SampleGrid coins;
+    SampleGrid boosts;
+    InitSampleGrid(coins, COIN_SPACING, map.width, map.height, numCoins);
+    InitSampleGrid(boosts, BOOST_SPACING, map.width, map.height, numBoosts);
+    
+    // Boosts first: there are few of them and they need the most room
+    SampleByCellSweep(map, boosts, coins, cells, reachable, 3, numBoosts, rng);
+    if (boosts.points.size() < (size_t)numBoosts) {
+        TraceLog(LOG_WARNING, "Only room for %d of %d boosts", (int)boosts.points.size(), numBoosts);
     }
     
-    return collectibles;
+    SampleByCellSweep(map, coins, boosts, cells, reachable, 2, numCoins, rng);
+    if (coins.points.size() < (size_t)numCoins) {
+        SampleBridson(map, coins, boosts, reachable, 2, numCoins, rng);
+    }
+    if (coins.points.size() < (size_t)numCoins) {
+        TraceLog(LOG_WARNING, "Only room for %d of %d coins", (int)coins.points.size(), numCoins);
+    }
+    
+    ArenaVector<PlacedItem> placed = MakeArenaVector<PlacedItem>(scratch.arena);
+    placed.reserve(coins.points.size() + boosts.points.size());
+    for (Vector2 p : coins.points) {
+        placed.push_back({p, 10, COIN});
+    }
+    for (Vector2 p : boosts.points) {
+        placed.push_back({p, 0, BOOST});
+    }
+    
+    BuildCollectibleStore(store, placed);
 }
 
-void UpdateCollectibles(std::vector<Collectible>& collectibles, Vector2 playerPos, int& totalGold, 
-                       bool& hasSpeedBoost, float& boostTimer, float goldMultiplier, Sound collectSound) {
-    for (auto& collectible : collectibles) {
-        if (!collectible.collected) {
-            float dx = playerPos.x - collectible.pos.x;
-            float dy = playerPos.y - collectible.pos.y;
-            float dist = sqrtf(dx * dx + dy * dy);
-            if (dist < 0.7f) {
-                collectible.collected = true;
-                if (IsSoundReady(collectSound)) {
-                    PlaySound(collectSound);
-                }
-                if (collectible.type == COIN) {
-                    totalGold += (int)(collectible.value * goldMultiplier);
-                } else if (collectible.type == BOOST) {
+void SetCollectibleArena(CollectibleStore& store, Arena* arena) {
+    store.count = 0;
+    store.x = MakeArenaVector<float>(arena);
+    store.y = MakeArenaVector<float>(arena);
+    store.value = MakeArenaVector<float>(arena);
+    store.type = MakeArenaVector<unsigned char>(arena);
+    store.alive = MakeArenaVector<unsigned long long>(arena);
+    store.cellStart = MakeArenaVector<int>(arena);
+}
+
+void InitCollectibles(CollectibleStore& store, int level, Vector2 playerStart, Rng* rng) {
+    int numCoins;
+    if (level == 1) {
+        numCoins = 5; // Exactly 5 coins in level 1 (5 * 10 = 50 gold for door)
+    } else {
+        numCoins = 15 + RngRange(rng, 10); // 15-25 coins in other levels
+    }
+    
+    // Add 1-2 speed boosts in safe locations (not in level 1)
+    int numBoosts = (level == 1) ? 0 : 1 + RngRange(rng, 2);
+    
+    PlaceCollectibles(store, numCoins, numBoosts, playerStart, rng);
+}
+
+// Squared-distance test of up to 32 items against p, bit i set on a hit.
+// Four items per step with SSE; the scalar loop handles the tail.
+static unsigned int PickupHitMask(const float* x, const float* y, int count, Vector2 p, float radiusSq) {
+    unsigned int mask = 0;
+    int i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128 px = _mm_set1_ps(p.x);
+    __m128 py = _mm_set1_ps(p.y);
+    __m128 r2 = _mm_set1_ps(radiusSq);
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), py);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        mask |= (unsigned int)_mm_movemask_ps(_mm_cmplt_ps(d2, r2)) << i;
+    }
+#endif
+    for (; i < count; i++) {
+        float dx = x[i] - p.x;
+        float dy = y[i] - p.y;
+        mask |= (unsigned int)(dx * dx + dy * dy < radiusSq) << i;
+    }
+    return mask;
+}
+
+bool UpdateCollectibles(CollectibleStore& store, Vector2 playerPos, int& totalGold, 
+                       bool& hasSpeedBoost, float& boostTimer, float goldMultiplier) {
+    int playerX = (int)playerPos.x;
+    int playerY = (int)playerPos.y;
+    if (playerX < 0 || playerX >= store.gridWidth) return false;
+    bool collected = false;
+    
+    // Pickup radius (0.7) is below one cell, so the 3x3 neighborhood covers it.
+    // Each row of three cells is one contiguous span of items.
+    int firstX = playerX > 0 ? playerX - 1 : 0;
+    int lastX = playerX < store.gridWidth - 1 ? playerX + 1 : playerX;
+    for (int cy = playerY - 1; cy <= playerY + 1; cy++) {
+        if (cy < 0 || cy >= store.gridHeight) continue;
+        int spanStart = store.cellStart[cy * store.gridWidth + firstX];
+        int spanEnd = store.cellStart[cy * store.gridWidth + lastX + 1];
+        
+        for (int base = spanStart; base < spanEnd; base += 32) {
+            int count = std::min(32, spanEnd - base);
+            unsigned int hits = PickupHitMask(&store.x[base], &store.y[base], count, playerPos, 0.7f * 0.7f);
+            hits &= AliveBits(store, base);
+            
+            // Apply effects from the mask
+            while (hits) {
+                int item = base + LowestBit(hits);
+                hits &= hits - 1;
+                store.alive[item >> 6] &= ~(1ULL << (item & 63));
+                collected = true;
+                if (store.type[item] == COIN) {
+                    totalGold += (int)(store.value[item] * goldMultiplier);
+                } else if (store.type[item] == BOOST) {
                     hasSpeedBoost = true;
                     boostTimer = 10.0f;  // 10 second boost
                 }
             }
         }
     }
+    return collected;
 }
 
-void DrawCollectibles(const std::vector<Collectible>& collectibles, Vector2 playerPos, Vector2 dirVec,
-                     float animTime, const float* depthBuffer, int screenWidth, int screenHeight) {
-    for (const auto& collectible : collectibles) {
-        if (collectible.collected) continue;
-        
-        // Calculate sprite position relative to player
-        float spriteX = collectible.pos.x - playerPos.x;
-        float spriteY = collectible.pos.y - playerPos.y;
-        
-        // Calculate distance to sprite
-        float spriteDistance = sqrtf(spriteX * spriteX + spriteY * spriteY);
-        
-        // Calculate plane perpendicular to direction
-        float planeX = -dirVec.y;
-        float planeY = dirVec.x;
-        
-        // Transform sprite with inverse camera matrix
-        float invDet = 1.0f / (planeX * dirVec.y - dirVec.x * planeY);
-        float transformX = invDet * (dirVec.y * spriteX - dirVec.x * spriteY);
-        float transformY = invDet * (-planeY * spriteX + planeX * spriteY);
-        
-        // Don't render if behind player or too close
-        if (transformY <= 0.2f) continue;
-        
-        // Screen X position
-        int spriteScreenX = (int)(((float)screenWidth / 2) * (1.0f + transformX / transformY));
-        
-        // Sprite size based on distance
-        int spriteHeight = abs((int)(screenHeight / transformY * 0.5f));
-        int spriteWidth = abs((int)(screenHeight / transformY * 0.5f));
-        
-        // Clamp size
-        /*
-        if (spriteHeight < 8) spriteHeight = 8;
-        if (spriteHeight > 500) spriteHeight = 500;
-        if (spriteWidth < 8) spriteWidth = 8;
-        if (spriteWidth > 500) spriteWidth = 500;
-        */
-        
-        int drawStartY = -spriteHeight / 2 + screenHeight / 2;
-        int drawEndY = spriteHeight / 2 + screenHeight / 2;
-        int drawStartX = -spriteWidth / 2 + spriteScreenX;
-        int drawEndX = spriteWidth / 2 + spriteScreenX;
-        
-        // Animation - bobbing effect
-        float bobOffset = sinf(animTime * 3.0f) * 10.0f;
-        drawStartY += (int)bobOffset;
-        drawEndY += (int)bobOffset;
-        
-        // Don't render if off screen
-        if (drawEndX < 0 || drawStartX >= screenWidth) continue;
-        
-        // Check depth buffer for occlusion - check multiple points across sprite
-        int checkPoints = 5;
-        int visiblePoints = 0;
-        
-        for (int i = 0; i < checkPoints; i++) {
-            int checkX = drawStartX + (drawEndX - drawStartX) * i / (checkPoints - 1);
-            if (checkX >= 0 && checkX < screenWidth) {
-                if (transformY < depthBuffer[checkX]) {
-                    visiblePoints++;
-                }
+// Draw a single collectible as a billboard sprite with depth test
+static void DrawCollectibleSprite(const SpriteAtlas* atlas, Vector2 pos, int type, Vector2 playerPos,
+                                  Vector2 dirVec, float animTime, const float* depthBuffer,
+                                  int screenWidth, int screenHeight, float focalLength) {
+    // Calculate sprite position relative to player
+    float spriteX = pos.x - playerPos.x;
+    float spriteY = pos.y - playerPos.y;
+    
+    // Calculate distance to sprite
+    float spriteDistance = sqrtf(spriteX * spriteX + spriteY * spriteY);
+    
+    // Calculate plane perpendicular to direction
+    float planeX = -dirVec.y;
+    float planeY = dirVec.x;
+    
+    // Transform sprite with inverse camera matrix
+    float invDet = 1.0f / (planeX * dirVec.y - dirVec.x * planeY);
+    float transformX = invDet * (dirVec.y * spriteX - dirVec.x * spriteY);
+    float transformY = invDet * (-planeY * spriteX + planeX * spriteY);
+    
+    // Don't render if behind player or too close
+    if (transformY <= 0.2f) return;
+    
+    // Screen X position
+    int spriteScreenX = (int)((float)screenWidth / 2 + focalLength * transformX / transformY);
+    
+    // Sprite size based on distance
+    int spriteHeight = abs((int)(focalLength / transformY * 0.5f));
+    int spriteWidth = abs((int)(focalLength / transformY * 0.5f));
+    
+    // Clamp size
+    /*
+    if (spriteHeight < 8) spriteHeight = 8;
+    if (spriteHeight > 500) spriteHeight = 500;
+    if (spriteWidth < 8) spriteWidth = 8;
+    if (spriteWidth > 500) spriteWidth = 500;
+    */
+    
+    int drawStartY = -spriteHeight / 2 + screenHeight / 2;
+    int drawEndY = spriteHeight / 2 + screenHeight / 2;
+    int drawStartX = -spriteWidth / 2 + spriteScreenX;
+    int drawEndX = spriteWidth / 2 + spriteScreenX;
+    
+    // Animation - bobbing effect
+    float bobOffset = sinf(animTime * 3.0f) * 10.0f;
+    drawStartY += (int)bobOffset;
+    drawEndY += (int)bobOffset;
+    
+    // Don't render if off screen
+    if (drawEndX < 0 || drawStartX >= screenWidth) return;
+    
+    // Check depth buffer for occlusion - check multiple points across sprite
+    int checkPoints = 5;
+    int visiblePoints = 0;
+    
+    for (int i = 0; i < checkPoints; i++) {
+        int checkX = drawStartX + (drawEndX - drawStartX) * i / (checkPoints - 1);
+        if (checkX >= 0 && checkX < screenWidth) {
+            if (transformY < depthBuffer[checkX]) {
+                visiblePoints++;
             }
         }
-        
-        // Only draw if at least 40% of check points are visible
-        if (visiblePoints < checkPoints * 0.4f) continue;
-        
-        // Draw collectible as yellow circle with glow
-        int centerX = (drawStartX + drawEndX) / 2;
-        int centerY = (drawStartY + drawEndY) / 2;
-        int radius = (drawEndX - drawStartX) / 3;
-        
-        // Ensure minimum size
-        if (radius < 5) radius = 5;
-        // if (radius > 30) radius = 30;
-        
-        // Glow effect
-        DrawCircle(centerX, centerY, radius * 2.0f, Color{255, 215, 0, 40});
-        DrawCircle(centerX, centerY, radius * 1.5f, Color{255, 215, 0, 80});
-        
-        // Main collectible
-        if (collectible.type == COIN) {
-            DrawCircle(centerX, centerY, radius, GOLD);
-        } else if (collectible.type == BOOST) {
-            DrawCircle(centerX, centerY, radius, BLUE);
-        }
-        
-        // Highlight
-        DrawCircle(centerX - radius/3, centerY - radius/3, (float)radius/3, YELLOW);
-        
-        // Draw $ text above collectible
-        int textSize = radius;
-        if (textSize < 12) textSize = 12;
-        // if (textSize > 25) textSize = 25;
-        
-        const char* dollarText = collectible.type == COIN ? "$" : "2x Speed";
-        int textWidth = MeasureText(dollarText, textSize);
-        if (collectible.type == COIN) {
-            DrawText(dollarText, centerX - textWidth/2, centerY - radius - textSize - 8, textSize, YELLOW);
-        } else if (collectible.type == BOOST) {
-            DrawText(dollarText, centerX - textWidth/2, centerY - radius - textSize - 8, textSize, BLUE);
+    }
+    
+    // Only draw if at least 40% of check points are visible
+    if (visiblePoints < checkPoints * 0.4f) return;
+    
+    // Pre-rendered coin/boost (glow and label baked in), bob already applied
+    int centerX = (drawStartX + drawEndX) / 2;
+    int centerY = (drawStartY + drawEndY) / 2;
+    int radius = (drawEndX - drawStartX) / 3;
+    
+    // Ensure minimum size
+    if (radius < 5) radius = 5;
+    
+    DrawAtlasSprite(atlas, type == COIN ? SPRITE_COIN : SPRITE_BOOST,
+                    { (float)centerX, (float)centerY }, (float)radius);
+}
+
+void DrawCollectibles(const CollectibleStore& store, const SpriteAtlas* atlas,
+                     const int* visibleCells, int visibleCellCount, Vector2 playerPos, Vector2 dirVec,
+                     float animTime, const float* depthBuffer, int screenWidth, int screenHeight,
+                     float focalLength) {
+    // Only items in cells the raycaster reached can be visible
+    for (int v = 0; v < visibleCellCount; v++) {
+        int cell = visibleCells[v];
+        for (int item = store.cellStart[cell]; item < store.cellStart[cell + 1]; item++) {
+            if (!IsAlive(store, item)) continue;
+            DrawCollectibleSprite(atlas, {store.x[item], store.y[item]}, store.type[item], playerPos,
+                                  dirVec, animTime, depthBuffer, screenWidth, screenHeight, focalLength);
         }
     }
 }
 
-void DrawCollectiblesMinimap(const std::vector<Collectible>& collectibles, int miniMapOffsetX,
+void DrawCollectiblesMinimap(const CollectibleStore& store, int miniMapOffsetX,
                             int miniMapOffsetY, int miniMapScale) {
-    for (const auto& collectible : collectibles) {
-        if (!collectible.collected) {
+    for (int word = 0; word < (int)store.alive.size(); word++) {
+        unsigned long long bits = store.alive[word];
+        while (bits) {
+            int item = word * 64 + LowestBit(bits);
+            bits &= bits - 1;
             DrawCircle(
-                miniMapOffsetX + (int)(collectible.pos.x * miniMapScale),
-                miniMapOffsetY + (int)(collectible.pos.y * miniMapScale),
-                3, collectible.type == COIN ? GOLD : BLUE
+                miniMapOffsetX + (int)(store.x[item] * miniMapScale),
+                miniMapOffsetY + (int)(store.y[item] * miniMapScale),
+                3, store.type[item] == COIN ? GOLD : BLUE
             );
         }
     }
 }
-
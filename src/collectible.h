@@ -2,32 +2,52 @@
 #define COLLECTIBLE_H
 
 #include <raylib.h>
-#include <vector>
+#include "arena.h"
+#include "rng.h"
+#include "sprites.h"
 
 #define COIN 0
 #define BOOST 1
 
-struct Collectible {
-    Vector2 pos;
-    bool collected;
-    float value;
-    int type;
+// Collectibles as a struct of arrays, sorted by map cell. The items of cell c
+// are [cellStart[c], cellStart[c + 1]), so a row of cells is one contiguous
+// span and the pickup test streams straight through x[] and y[].
+struct CollectibleStore {
+    int count;
+    ArenaVector<float> x;
+    ArenaVector<float> y;
+    ArenaVector<float> value;
+    ArenaVector<unsigned char> type;       // COIN or BOOST
+    ArenaVector<unsigned long long> alive; // Bit i set while item i is uncollected
+    int gridWidth;
+    int gridHeight;
+    ArenaVector<int> cellStart;            // gridWidth * gridHeight + 1 offsets
 };
 
-// Initialize collectibles in the world
-std::vector<Collectible> InitCollectibles(int level);
+// Empty the store and have it allocate from arena (null = the heap)
+void SetCollectibleArena(CollectibleStore& store, Arena* arena);
 
-// Check and handle player pickup
-void UpdateCollectibles(std::vector<Collectible>& collectibles, Vector2 playerPos, int& totalGold, 
-                       bool& hasSpeedBoost, float& boostTimer, float goldMultiplier, Sound collectSound);
+// Initialize collectibles for a level and build their grid
+void InitCollectibles(CollectibleStore& store, int level, Vector2 playerStart, Rng* rng);
 
-// Draw collectibles as 3D sprites with depth
-void DrawCollectibles(const std::vector<Collectible>& collectibles, Vector2 playerPos, Vector2 dirVec, 
-                     float animTime, const float* depthBuffer, int screenWidth, int screenHeight);
+// Place coins (2+ units apart) and boosts (3+ units from everything) with
+// Poisson-disk sampling, restricted to cells reachable from startPos
+void PlaceCollectibles(CollectibleStore& store, int numCoins, int numBoosts, Vector2 startPos, Rng* rng);
+
+// Check and handle player pickup (only the player's 3x3 cell neighborhood is tested).
+// Returns true if anything was collected.
+bool UpdateCollectibles(CollectibleStore& store, Vector2 playerPos, int& totalGold, 
+                       bool& hasSpeedBoost, float& boostTimer, float goldMultiplier);
+
+// Draw collectibles in the given map cells as 3D atlas sprites with depth,
+// scaled by the view's focal length (see GetFocalLength)
+void DrawCollectibles(const CollectibleStore& store, const SpriteAtlas* atlas,
+                     const int* visibleCells, int visibleCellCount, Vector2 playerPos, Vector2 dirVec,
+                     float animTime, const float* depthBuffer, int screenWidth, int screenHeight,
+                     float focalLength);
 
 // Draw collectibles on minimap
-void DrawCollectiblesMinimap(const std::vector<Collectible>& collectibles, int miniMapOffsetX, 
+void DrawCollectiblesMinimap(const CollectibleStore& store, int miniMapOffsetX, 
                             int miniMapOffsetY, int miniMapScale);
 
 #endif
-
@@ -3,28 +3,37 @@
 
 #include <raylib.h>
 #include <vector>
+#include "pathfinding.h"
+#include "sprites.h"
 
 struct Enemy {
     Vector2 position;
+    Vector2 prevPosition; // Position at the previous tick, for render interpolation
     float speed;
     float detectionRange;
     float attackRange;
     bool isActive;
     bool isChasing;
-    std::vector<Vector2> path; // A* path
+    ArenaVector<Vector2> path; // Planned path (cell centers)
     int currentPathIndex;
     float pathRecalcTimer; // Timer to recalculate path
+    PathPlanner planner; // Incremental D* Lite search, repaired on each replan
 };
 
 // Initialize enemy at far position from player
 void InitEnemy(Enemy* enemy, Vector2 playerPos, int mapWidth, int mapHeight, int level);
 
+// Have the enemy's path and planner allocate from arena (null = the heap);
+// call before InitEnemy
+void SetEnemyArena(Enemy* enemy, Arena* arena);
+
 // Update enemy AI
 void UpdateEnemy(Enemy* enemy, Vector2 playerPos, float deltaTime);
 
-// Draw enemy as 3D sprite
-void DrawEnemy(const Enemy* enemy, Vector2 playerPos, Vector2 dirVec, 
-              const float* depthBuffer, int screenWidth, int screenHeight);
+// Draw enemy as 3D atlas sprite, interpolated alpha between the last two ticks,
+// scaled by the view's focal length (see GetFocalLength)
+void DrawEnemy(const Enemy* enemy, const SpriteAtlas* atlas, float alpha, Vector2 playerPos, Vector2 dirVec, 
+              const float* depthBuffer, int screenWidth, int screenHeight, float focalLength);
 
 // Check if enemy caught player
 bool IsPlayerCaught(const Enemy* enemy, Vector2 playerPos);
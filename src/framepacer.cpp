@@ -0,0 +1,68 @@
+#include "framepacer.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+// No raylib here: windows.h clashes with its names
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <mmsystem.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+static double PacerSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifdef _WIN32
+// Sleep() rounds up to the 15.6 ms scheduler tick; a high-resolution waitable
+// timer (Windows 10 1803+) wakes within a fraction of a millisecond. Older
+// systems fall back to a 1 ms timer period. The main and sim threads both
+// pace, so each waits on its own timer.
+struct PacerTimer {
+    HANDLE handle;
+    PacerTimer() : handle(CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS)) {}
+    ~PacerTimer() {
+        if (handle != NULL) CloseHandle(handle);
+    }
+};
+
+static void PacerSleep(double seconds) {
+    static thread_local PacerTimer timer;
+    if (timer.handle == NULL) {
+        // The period is process-wide, so setting it once covers every thread
+        static std::once_flag periodSet;
+        std::call_once(periodSet, [] { timeBeginPeriod(1); });
+        Sleep((DWORD)(seconds * 1000.0));
+        return;
+    }
+    LARGE_INTEGER due;
+    due.QuadPart = -(LONGLONG)(seconds * 1e7); // Relative, in 100 ns units
+    SetWaitableTimer(timer.handle, &due, 0, NULL, NULL, FALSE);
+    WaitForSingleObject(timer.handle, INFINITE);
+}
+#else
+// nanosleep-based; wakes within tens of microseconds on Linux and macOS
+static void PacerSleep(double seconds) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+#endif
+
+void SetFramePacerRate(FramePacer* pacer, int fps) {
+    pacer->period = fps > 0 ? 1.0 / fps : 0.0;
+    pacer->next = 0.0;
+}
+
+void WaitNextFrame(FramePacer* pacer) {
+    if (pacer->period <= 0.0) return;
+    double now = PacerSeconds();
+    if (pacer->next <= 0.0 || now > pacer->next + pacer->period) {
+        pacer->next = now;
+    } else if (pacer->next > now) {
+        PacerSleep(pacer->next - now);
+    }
+    pacer->next += pacer->period;
+}
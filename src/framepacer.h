@@ -0,0 +1,19 @@
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+// Frame rate limiter that sleeps to absolute deadlines instead of
+// busy-waiting. Deadlines advance by exactly one period, so sleep overshoot
+// doesn't accumulate; a frame that runs more than a period late restarts the
+// schedule rather than rushing to catch up.
+struct FramePacer {
+    double period; // Seconds per frame, 0 = uncapped
+    double next;   // Deadline of the next frame, 0 before the first
+};
+
+// Cap at fps frames per second (0 or less = uncapped)
+void SetFramePacerRate(FramePacer* pacer, int fps);
+
+// Sleep until the next frame is due (call once per frame)
+void WaitNextFrame(FramePacer* pacer);
+
+#endif
@@ -2,60 +2,25 @@
 #include "map.h"
 #include "collectible.h"
 #include "enemy.h"
+#include "profiler.h"
+#include "trace.h"
+#include "raycaster.h"
 #include <raymath.h>
 #include <cmath>
 #include <stdlib.h>
-#include <time.h>
+#include <algorithm>
+
+// Map cells reached by the raycaster this frame, used to cull collectible buckets
+static VisibleCellSet visibleCells;
+static std::vector<RayHit> columnHits; // Per screen column, sized in DrawGame
+static std::vector<float> depthBuffer;
 
 void InitGame(GameState* game) {
-    srand(time(NULL));
-    
-    // Only initialize audio and load resources once
-    static bool audioInitialized = false;
-    if (!audioInitialized) {
-        InitAudioDevice();
-        game->collectSound = LoadSound("assets/collect.wav");
-        game->stabSound = LoadSound("assets/stab.wav");
-        game->purchaseSound = LoadSound("assets/purchase.wav");
-        game->jumpscareSound = LoadSound("assets/jumpscare.wav");
-        game->horrorMusic = LoadMusicStream("assets/horror-music.mp3");
-        
-        if (!IsSoundReady(game->collectSound)) {
-            TraceLog(LOG_ERROR, "Failed to load collect.wav");
-        }
-        if (!IsSoundReady(game->stabSound)) {
-            TraceLog(LOG_ERROR, "Failed to load stab.wav");
-        }
-        if (!IsSoundReady(game->purchaseSound)) {
-            TraceLog(LOG_ERROR, "Failed to load purchase.wav");
-        }
-        if (!IsSoundReady(game->jumpscareSound)) {
-            TraceLog(LOG_ERROR, "Failed to load jumpscare.wav");
-        }
-        if (!IsMusicReady(game->horrorMusic)) {
-            TraceLog(LOG_ERROR, "Failed to load horror-music.mp3");
-        }
-        SetSoundVolume(game->collectSound, 0.5f);
-        SetSoundVolume(game->stabSound, 0.7f);
-        SetSoundVolume(game->purchaseSound, 0.6f);
-        SetSoundVolume(game->jumpscareSound, 0.2f);
-        SetMusicVolume(game->horrorMusic, 0.4f);
-        game->horrorMusic.looping = true;
-        
-        audioInitialized = true;
-    }
-    
-    // Stop music if playing before resetting
-    if (IsMusicReady(game->horrorMusic) && IsMusicStreamPlaying(game->horrorMusic)) {
-        StopMusicStream(game->horrorMusic);
-    }
-    
-    // Start music in main menu
-    if (IsMusicReady(game->horrorMusic)) {
-        PlayMusicStream(game->horrorMusic);
-    }
+    // Restart music from the top in main menu
+    RestartGameMusic();
     
     game->player.angle = 0.0f;
+    game->player.prevAngle = 0.0f;
     game->player.mouseSensitivity = 0.003f;
     game->player.hasSpeedBoost = false;
     game->player.boostTimer = 0.0f;
@@ -68,13 +33,13 @@ void InitGame(GameState* game) {
     game->FOV = 60.0f * DEG2RAD;
     game->currentLevel = 1;
     game->mode = MAIN_MENU;
-    game->loadingTimer = 0.0f;
     game->selectedPerk = -1;
     game->stabEffectTimer = 0.0f;
     game->isBeingAttacked = false;
     game->shopContinuePressed = false;
     game->menuSelection = 0;
     game->showEnemyOnMinimap = false;
+    game->jumpscareLooping = false;
 }
 
 void InitLevel(GameState* game, int level) {
@@ -82,103 +47,189 @@ void InitLevel(GameState* game, int level) {
     game->stabEffectTimer = 0.0f;
     game->isBeingAttacked = false;
     
-    // Set map and door cost based on level
-    if (level == 1) {
-        currentMap = (const int*)worldMap1;
-        currentMapWidth = MAP_WIDTH;
-        currentMapHeight = MAP_HEIGHT;
-        game->player.position = { 8.0f, 8.0f };
-        game->doorCost = 50;
-    } else if (level == 2) {
-        currentMap = (const int*)worldMap2;
-        currentMapWidth = MAP_WIDTH_2;
-        currentMapHeight = MAP_HEIGHT_2;
-        game->player.position = { 10.0f, 10.0f };
-        game->doorCost = 80;
-    } else if (level == 3) {
-        currentMap = (const int*)worldMap3;
-        currentMapWidth = MAP_WIDTH_2;
-        currentMapHeight = MAP_HEIGHT_2;
-        game->player.position = { 10.0f, 10.0f };
-        game->doorCost = 120;
-    } else if (level == 4) {
-        currentMap = (const int*)worldMap4;
-        currentMapWidth = MAP_WIDTH_2;
-        currentMapHeight = MAP_HEIGHT_2;
-        game->player.position = { 10.0f, 10.0f };
-        game->doorCost = 150;
-    } else if (level == 5) {
-        currentMap = (const int*)worldMap5;
-        currentMapWidth = MAP_WIDTH_2;
-        currentMapHeight = MAP_HEIGHT_2;
-        game->player.position = { 10.0f, 10.0f };
-        game->doorCost = 200;
-    }
-    
-    game->collectibles = InitCollectibles(level);
-    InitEnemy(&game->enemy, game->player.position, currentMapWidth, currentMapHeight, level);
+    // Take the level built in the background (waiting for it if still
+    // running, so the result never depends on timing), or build it now.
+    // Either way it was built in the spare level arena; the old level's
+    // containers end up in data and are dropped on return.
+    if (game->loader.level != level) {
+        BuildLevelNow(&game->loader, level, NextRng(&game->rng));
+    }
+    LevelData data = {};
+    TakeLoadedLevel(&game->loader, &data);
+    
+    // Swap the level in between ticks
+    SetCurrentMap(data.map, data.mapWidth, data.mapHeight);
+    game->player.position = data.playerStart;
+    game->doorCost = data.doorCost;
+    std::swap(game->collectibles, data.collectibles);
+    std::swap(game->enemy, data.enemy);
     game->mode = PLAYING;
     
+    // New level: don't interpolate from the old position
+    game->player.prevPosition = game->player.position;
+    game->player.prevAngle = game->player.angle;
+    CaptureGameSnapshot(game, &game->levelStart);
+    
     // Start music when level begins (if not already playing)
-    if (IsMusicReady(game->horrorMusic) && !IsMusicStreamPlaying(game->horrorMusic)) {
-        PlayMusicStream(game->horrorMusic);
+    PlayGameMusic();
+}
+
+// Post jumpscare loop changes only, so the audio queue sees one event per edge
+static void SetJumpscareLoop(GameState* game, bool looping) {
+    if (game->jumpscareLooping == looping) return;
+    game->jumpscareLooping = looping;
+    LoopGameSound(SOUND_JUMPSCARE, looping);
+}
+
+// Start building level in the background. Levels after the first open the
+// shop right away, so the build overlaps browsing; otherwise (or if the
+// player continues before it's done) the loading screen waits for it. With
+// foregroundLoads the level is only built when entered.
+static void BeginLevelLoad(GameState* game, int level) {
+    game->currentLevel = level;
+    if (level <= MAX_LEVELS && !game->foregroundLoads) {
+        StartLevelLoad(&game->loader, level, NextRng(&game->rng));
+    }
+    if (level == 1 || level > MAX_LEVELS) {
+        game->mode = LOADING;
+    } else {
+        game->mode = SHOP;
+        GenerateShopPerks(game);
+    }
+}
+
+// The next level can be entered this tick: its background build is done, or
+// none is running (e.g. after a snapshot restore) and InitLevel builds it now
+static bool CanEnterLevel(const GameState* game, const GameInput* input) {
+    return input->levelReady || game->loader.level != game->currentLevel;
+}
+
+void DescribePerk(Perk* perk) {
+    if (perk->type == 0) {
+        perk->name = "Gold Collector";
+        perk->description = "Collect +50% more gold";
+    } else if (perk->type == 1) {
+        perk->name = "Speed Runner";
+        perk->description = "+1.0 movement speed";
+    } else if (perk->type == 2) {
+        perk->name = "Long Boost";
+        perk->description = "Speed boosts last +5s";
+    } else {
+        perk->name = "Enemy Radar";
+        perk->description = "Reveals enemy on minimap";
     }
 }
 
 void GenerateShopPerks(GameState* game) {
     // Perk 0: Gold Multiplier
     game->shopPerks[0].type = 0;
-    game->shopPerks[0].name = "Gold Collector";
-    game->shopPerks[0].description = "Collect +50% more gold";
-    game->shopPerks[0].cost = 30 + (rand() % 20);
+    game->shopPerks[0].cost = 30 + RngRange(&game->rng, 20);
     game->shopPerks[0].value = 0.5f;
     
     // Perk 1: Speed Boost
     game->shopPerks[1].type = 1;
-    game->shopPerks[1].name = "Speed Runner";
-    game->shopPerks[1].description = "+1.0 movement speed";
-    game->shopPerks[1].cost = 20 + (rand() % 15);
+    game->shopPerks[1].cost = 20 + RngRange(&game->rng, 15);
     game->shopPerks[1].value = 1.0f;
     
     // Perk 2: Boost Duration or Enemy Radar
     if (!game->showEnemyOnMinimap && game->currentLevel >= 3) {
         // Enemy Radar (only if not already purchased, appears after level 2)
         game->shopPerks[2].type = 3;
-        game->shopPerks[2].name = "Enemy Radar";
-        game->shopPerks[2].description = "Reveals enemy on minimap";
-        game->shopPerks[2].cost = 40 + (rand() % 20);
+        game->shopPerks[2].cost = 40 + RngRange(&game->rng, 20);
         game->shopPerks[2].value = 1.0f;
     } else {
         // Boost Duration
         game->shopPerks[2].type = 2;
-        game->shopPerks[2].name = "Long Boost";
-        game->shopPerks[2].description = "Speed boosts last +5s";
-        game->shopPerks[2].cost = 25 + (rand() % 15);
+        game->shopPerks[2].cost = 25 + RngRange(&game->rng, 15);
         game->shopPerks[2].value = 5.0f;
     }
+    
+    for (int i = 0; i < 3; i++) {
+        DescribePerk(&game->shopPerks[i]);
+    }
+}
+
+void PollGameInput(GameInput* input) {
+    input->moveForward = IsKeyDown(KEY_W);
+    input->moveBack = IsKeyDown(KEY_S);
+    input->moveLeft = IsKeyDown(KEY_A);
+    input->moveRight = IsKeyDown(KEY_D);
+    input->lookDelta += GetMouseDelta().x;
+    
+    // Edges stay latched until a tick consumes them, so frames that run zero
+    // ticks don't drop key presses
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) input->upPressed = true;
+    if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) input->downPressed = true;
+    if (IsKeyPressed(KEY_ENTER)) input->enterPressed = true;
+    if (IsKeyPressed(KEY_SPACE)) input->spacePressed = true;
+    if (IsKeyPressed(KEY_R)) input->restartPressed = true;
+    if (IsKeyPressed(KEY_ONE)) input->perkPressed[0] = true;
+    if (IsKeyPressed(KEY_TWO)) input->perkPressed[1] = true;
+    if (IsKeyPressed(KEY_THREE)) input->perkPressed[2] = true;
 }
 
-void UpdateGame(GameState* game, float deltaTime) {
+void ConsumeGameInput(GameInput* input) {
+    input->lookDelta = 0.0f;
+    input->upPressed = false;
+    input->downPressed = false;
+    input->enterPressed = false;
+    input->spacePressed = false;
+    input->restartPressed = false;
+    input->perkPressed[0] = false;
+    input->perkPressed[1] = false;
+    input->perkPressed[2] = false;
+}
+
+void CaptureRenderState(const GameState* game, RenderState* state) {
+    state->mode = game->mode;
+    state->player = game->player;
+    state->enemy.position = game->enemy.position;
+    state->enemy.prevPosition = game->enemy.prevPosition;
+    state->enemy.isActive = game->enemy.isActive;
+    state->collectibles = game->collectibles; // Reuses the vectors' capacity
+    state->map = currentMap;
+    state->mapWidth = currentMapWidth;
+    state->mapHeight = currentMapHeight;
+    state->sprites = &game->sprites;
+    state->animTime = game->animTime;
+    state->FOV = game->FOV;
+    state->totalGold = game->totalGold;
+    state->doorCost = game->doorCost;
+    state->currentLevel = game->currentLevel;
+    for (int i = 0; i < 3; i++) {
+        state->shopPerks[i] = game->shopPerks[i];
+    }
+    state->selectedPerk = game->selectedPerk;
+    state->shopContinuePressed = game->shopContinuePressed;
+    state->menuSelection = game->menuSelection;
+    state->stabEffectTimer = game->stabEffectTimer;
+    state->isBeingAttacked = game->isBeingAttacked;
+    state->showEnemyOnMinimap = game->showEnemyOnMinimap;
+    state->loadProgress = GetLevelLoadProgress(&game->loader);
+}
+
+void UpdateGame(GameState* game, const GameInput* input, float deltaTime) {
+    TRACE_SCOPE("UpdateGame");
     game->animTime += deltaTime;
     
-    // Update music stream only when playing
-    if (IsMusicReady(game->horrorMusic) && IsMusicStreamPlaying(game->horrorMusic)) {
-        UpdateMusicStream(game->horrorMusic);
-    }
+    // Remember last tick's pose for render interpolation
+    game->player.prevPosition = game->player.position;
+    game->player.prevAngle = game->player.angle;
+    game->enemy.prevPosition = game->enemy.position;
     
     if (game->mode == MAIN_MENU) {
         // Menu navigation
-        if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) {
+        if (input->upPressed) {
             game->menuSelection = 0;
         }
-        if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) {
+        if (input->downPressed) {
             game->menuSelection = 1;
         }
         
-        if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE)) {
+        if (input->enterPressed || input->spacePressed) {
             if (game->menuSelection == 0) {
                 // Start game
-                InitLevel(game, 1);
+                BeginLevelLoad(game, 1);
             } else {
                 // Exit game
                 // Note: Actual exit handled in main.cpp
@@ -189,53 +240,47 @@ void UpdateGame(GameState* game, float deltaTime) {
     
     if (game->mode == GAME_WON) {
         // Press R to restart
-        if (IsKeyPressed(KEY_R)) {
+        if (input->restartPressed) {
             InitGame(game);
         }
         return;
     }
     
     if (game->mode == GAME_LOST) {
-        // Press SPACE to return to main menu
-        if (IsKeyPressed(KEY_SPACE)) {
+        // Press R to retry the level from its start, SPACE to return to main menu
+        if (input->restartPressed && RestoreGameSnapshot(game, &game->levelStart)) {
+            PlayGameMusic();
+        } else if (input->spacePressed) {
             InitGame(game);
         }
         return;
     }
     
     if (game->mode == LOADING) {
-        game->loadingTimer += deltaTime;
-        if (game->loadingTimer >= 1.5f) {  // Faster loading
-            if (game->currentLevel > MAX_LEVELS) {
-                game->mode = GAME_WON;
-                // Stop music when game is won
-                if (IsMusicReady(game->horrorMusic)) {
-                    StopMusicStream(game->horrorMusic);
-                }
-            } else {
-                game->mode = SHOP;
-                game->loadingTimer = 0.0f;
-                GenerateShopPerks(game);
-            }
+        // Leave as soon as the background build is done
+        if (game->currentLevel > MAX_LEVELS) {
+            game->mode = GAME_WON;
+            // Stop music when game is won
+            StopGameMusic();
+        } else if (CanEnterLevel(game, input)) {
+            InitLevel(game, game->currentLevel);
         }
         return;
     }
     
     if (game->mode == SHOP) {
         // Shop input handling
-        if (IsKeyPressed(KEY_ONE)) game->selectedPerk = 0;
-        if (IsKeyPressed(KEY_TWO)) game->selectedPerk = 1;
-        if (IsKeyPressed(KEY_THREE)) game->selectedPerk = 2;
+        if (input->perkPressed[0]) game->selectedPerk = 0;
+        if (input->perkPressed[1]) game->selectedPerk = 1;
+        if (input->perkPressed[2]) game->selectedPerk = 2;
         
         // Buy perk
-        if (game->selectedPerk >= 0 && IsKeyPressed(KEY_ENTER)) {
+        if (game->selectedPerk >= 0 && input->enterPressed) {
             Perk* perk = &game->shopPerks[game->selectedPerk];
             if (game->totalGold >= perk->cost) {
                 game->totalGold -= perk->cost;
                 
-                if (IsSoundReady(game->purchaseSound)) {
-                    PlaySound(game->purchaseSound);
-                }
+                PlayGameSound(SOUND_PURCHASE);
                 
                 if (perk->type == 0) {
                     game->player.goldMultiplier += perk->value;
@@ -253,13 +298,18 @@ void UpdateGame(GameState* game, float deltaTime) {
         }
         
         // Continue to next level (double press confirmation)
-        if (IsKeyPressed(KEY_SPACE)) {
+        if (input->spacePressed) {
             if (!game->shopContinuePressed) {
                 game->shopContinuePressed = true;
             } else {
-                // Second press - continue
+                // Second press - continue: swap in the prefetched level,
+                // or wait on the loading screen if it isn't built yet
                 game->shopContinuePressed = false;
-                InitLevel(game, game->currentLevel);
+                if (CanEnterLevel(game, input)) {
+                    InitLevel(game, game->currentLevel);
+                } else {
+                    game->mode = LOADING;
+                }
             }
         }
         return;
@@ -275,23 +325,22 @@ void UpdateGame(GameState* game, float deltaTime) {
     }
     
     // Update enemy
-    UpdateEnemy(&game->enemy, game->player.position, deltaTime);
+    {
+        PROFILE_SCOPE(PHASE_ENEMY);
+        UpdateEnemy(&game->enemy, game->player.position, deltaTime);
+    }
     
     // Play jumpscare sound in loop when enemy is close
     if (game->enemy.isActive) {
         float distToEnemy = Vector2Distance(game->enemy.position, game->player.position);
         float jumpscareDistance = 2.7f; // Start playing when enemy is within 4 units
         
-        if (distToEnemy < jumpscareDistance) {
+        if (distToEnemy < jumpscareDistance && HasLineOfSight(game->enemy.position, game->player.position)) {
             // Keep sound playing in loop (restart when finished)
-            if (IsSoundReady(game->jumpscareSound) && !IsSoundPlaying(game->jumpscareSound)) {
-                PlaySound(game->jumpscareSound);
-            }
+            SetJumpscareLoop(game, true);
         } else {
             // Stop sound when enemy is far
-            if (IsSoundReady(game->jumpscareSound) && IsSoundPlaying(game->jumpscareSound)) {
-                StopSound(game->jumpscareSound);
-            }
+            SetJumpscareLoop(game, false);
         }
     }
     
@@ -300,21 +349,15 @@ void UpdateGame(GameState* game, float deltaTime) {
         if (!game->isBeingAttacked) {
             game->isBeingAttacked = true;
             game->stabEffectTimer = 2.0f;  // Stab effect duration
-            if (IsSoundReady(game->stabSound)) {
-                PlaySound(game->stabSound);
-            }
+            PlayGameSound(SOUND_STAB);
         }
         
         if (game->stabEffectTimer < 1.5f) {  // Die after 0.5s of effect
             game->mode = GAME_LOST;
             // Stop music when player dies
-            if (IsMusicReady(game->horrorMusic)) {
-                StopMusicStream(game->horrorMusic);
-            }
+            StopGameMusic();
             // Stop jumpscare sound
-            if (IsSoundReady(game->jumpscareSound) && IsSoundPlaying(game->jumpscareSound)) {
-                StopSound(game->jumpscareSound);
-            }
+            SetJumpscareLoop(game, false);
             return;
         }
     }
@@ -329,8 +372,7 @@ void UpdateGame(GameState* game, float deltaTime) {
     }
     
     // Rotation
-    Vector2 mouseDelta = GetMouseDelta();
-    game->player.angle += mouseDelta.x * game->player.mouseSensitivity;
+    game->player.angle += input->lookDelta * game->player.mouseSensitivity;
     
     // Direction vectors
     Vector2 dirVec = { cosf(game->player.angle), sinf(game->player.angle) };
@@ -338,10 +380,10 @@ void UpdateGame(GameState* game, float deltaTime) {
     
     // Movement
     Vector2 moveDir = { 0, 0 };
-    if (IsKeyDown(KEY_W)) { moveDir.x += dirVec.x; moveDir.y += dirVec.y; }
-    if (IsKeyDown(KEY_S)) { moveDir.x -= dirVec.x; moveDir.y -= dirVec.y; }
-    if (IsKeyDown(KEY_A)) { moveDir.x -= rightVec.x; moveDir.y -= rightVec.y; }
-    if (IsKeyDown(KEY_D)) { moveDir.x += rightVec.x; moveDir.y += rightVec.y; }
+    if (input->moveForward) { moveDir.x += dirVec.x; moveDir.y += dirVec.y; }
+    if (input->moveBack) { moveDir.x -= dirVec.x; moveDir.y -= dirVec.y; }
+    if (input->moveLeft) { moveDir.x -= rightVec.x; moveDir.y -= rightVec.y; }
+    if (input->moveRight) { moveDir.x += rightVec.x; moveDir.y += rightVec.y; }
     
     // Apply movement with collision
     if (moveDir.x != 0 || moveDir.y != 0) {
@@ -362,17 +404,11 @@ void UpdateGame(GameState* game, float deltaTime) {
         
         // Check if passing through door
         if (tile == 2 && game->totalGold >= game->doorCost) {
-            game->mode = LOADING;
-            game->loadingTimer = 0.0f;
-            game->currentLevel++;
+            BeginLevelLoad(game, game->currentLevel + 1);
             // Stop music when entering door
-            if (IsMusicReady(game->horrorMusic)) {
-                StopMusicStream(game->horrorMusic);
-            }
+            StopGameMusic();
             // Stop jumpscare sound
-            if (IsSoundReady(game->jumpscareSound) && IsSoundPlaying(game->jumpscareSound)) {
-                StopSound(game->jumpscareSound);
-            }
+            SetJumpscareLoop(game, false);
             return;
         }
         
@@ -387,17 +423,11 @@ void UpdateGame(GameState* game, float deltaTime) {
         tile = GetMapTile(mapX, mapY);
         
         if (tile == 2 && game->totalGold >= game->doorCost) {
-            game->mode = LOADING;
-            game->loadingTimer = 0.0f;
-            game->currentLevel++;
+            BeginLevelLoad(game, game->currentLevel + 1);
             // Stop music when entering door
-            if (IsMusicReady(game->horrorMusic)) {
-                StopMusicStream(game->horrorMusic);
-            }
+            StopGameMusic();
             // Stop jumpscare sound
-            if (IsSoundReady(game->jumpscareSound) && IsSoundPlaying(game->jumpscareSound)) {
-                StopSound(game->jumpscareSound);
-            }
+            SetJumpscareLoop(game, false);
             return;
         }
         
@@ -407,41 +437,50 @@ void UpdateGame(GameState* game, float deltaTime) {
     }
     
     // Update collectibles
-    UpdateCollectibles(game->collectibles, game->player.position, game->totalGold, 
-                      game->player.hasSpeedBoost, game->player.boostTimer, game->player.goldMultiplier, game->collectSound);
+    PROFILE_SCOPE(PHASE_COLLECTIBLES);
+    if (UpdateCollectibles(game->collectibles, game->player.position, game->totalGold, 
+                           game->player.hasSpeedBoost, game->player.boostTimer, game->player.goldMultiplier)) {
+        PlayGameSound(SOUND_COLLECT);
+    }
 }
 
 void DrawStabEffect(float intensity) {
     // Red bloody knife slash effect
     unsigned char alpha = (unsigned char)(intensity * 200);
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
+    float scaleX = (float)screenWidth / DEFAULT_SCREEN_WIDTH;
+    float scaleY = (float)screenHeight / DEFAULT_SCREEN_HEIGHT;
     
     // Red vignette
     for (int i = 0; i < 100; i++) {
         unsigned char vignetteAlpha = (unsigned char)(i * 2.5f * intensity);
         DrawRectangleLinesEx(
-            Rectangle{(float)i, (float)i, (float)SCREEN_WIDTH - i*2, (float)SCREEN_HEIGHT - i*2},
+            Rectangle{(float)i, (float)i, (float)screenWidth - i*2, (float)screenHeight - i*2},
             2, Color{255, 0, 0, vignetteAlpha}
         );
     }
     
-    // Slash marks
-    DrawLineEx(Vector2{100, 100}, Vector2{400, 300}, 5, Color{255, 0, 0, alpha});
-    DrawLineEx(Vector2{500, 150}, Vector2{700, 400}, 5, Color{255, 0, 0, alpha});
-    DrawLineEx(Vector2{200, 400}, Vector2{350, 500}, 5, Color{255, 0, 0, alpha});
+    // Slash marks, placed for the default size and stretched to the window
+    DrawLineEx(Vector2{100 * scaleX, 100 * scaleY}, Vector2{400 * scaleX, 300 * scaleY}, 5, Color{255, 0, 0, alpha});
+    DrawLineEx(Vector2{500 * scaleX, 150 * scaleY}, Vector2{700 * scaleX, 400 * scaleY}, 5, Color{255, 0, 0, alpha});
+    DrawLineEx(Vector2{200 * scaleX, 400 * scaleY}, Vector2{350 * scaleX, 500 * scaleY}, 5, Color{255, 0, 0, alpha});
     
     // Screen flash
-    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Color{255, 0, 0, (unsigned char)(alpha * 0.3f)});
+    DrawRectangle(0, 0, screenWidth, screenHeight, Color{255, 0, 0, (unsigned char)(alpha * 0.3f)});
 }
 
 void DrawLoadingScreen(float progress) {
     BeginDrawing();
     ClearBackground(BLACK);
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
     
     // Half-Life style loading
     int barWidth = 400;
     int barHeight = 30;
-    int barX = SCREEN_WIDTH / 2 - barWidth / 2;
-    int barY = SCREEN_HEIGHT / 2 - barHeight / 2;
+    int barX = screenWidth / 2 - barWidth / 2;
+    int barY = screenHeight / 2 - barHeight / 2;
     
     DrawRectangle(barX, barY, barWidth, barHeight, DARKGRAY);
     DrawRectangle(barX, barY, (int)(barWidth * progress), barHeight, ORANGE);
@@ -449,28 +488,30 @@ void DrawLoadingScreen(float progress) {
     
     const char* text = "LOADING...";
     int textWidth = MeasureText(text, 40);
-    DrawText(text, SCREEN_WIDTH / 2 - textWidth / 2, barY - 60, 40, WHITE);
+    DrawText(text, screenWidth / 2 - textWidth / 2, barY - 60, 40, WHITE);
     
     const char* percentText = TextFormat("%.0f%%", progress * 100);
     int percentWidth = MeasureText(percentText, 20);
-    DrawText(percentText, SCREEN_WIDTH / 2 - percentWidth / 2, barY + barHeight + 20, 20, WHITE);
+    DrawText(percentText, screenWidth / 2 - percentWidth / 2, barY + barHeight + 20, 20, WHITE);
     
     EndDrawing();
 }
 
-void DrawShop(const GameState* game) {
+void DrawShop(const RenderState* game) {
     BeginDrawing();
     ClearBackground(Color{20, 20, 30, 255});
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
     
     // Title
     const char* title = "UPGRADE SHOP";
     int titleWidth = MeasureText(title, 50);
-    DrawText(title, SCREEN_WIDTH / 2 - titleWidth / 2, 20, 50, GOLD);
+    DrawText(title, screenWidth / 2 - titleWidth / 2, 20, 50, GOLD);
     
     // Current gold
     const char* goldText = TextFormat("Current Gold: $%d", game->totalGold);
     int goldWidth = MeasureText(goldText, 30);
-    DrawText(goldText, SCREEN_WIDTH / 2 - goldWidth / 2, 80, 30, GREEN);
+    DrawText(goldText, screenWidth / 2 - goldWidth / 2, 80, 30, GREEN);
     
     // Current stats box
     DrawRectangle(20, 130, 260, 120, Color{30, 30, 50, 255});
@@ -484,7 +525,7 @@ void DrawShop(const GameState* game) {
     int perkWidth = 220;
     int perkHeight = 200;
     int spacing = 20;
-    int startX = (SCREEN_WIDTH - (perkWidth * 3 + spacing * 2)) / 2;
+    int startX = (screenWidth - (perkWidth * 3 + spacing * 2)) / 2;
     int startY = 270;
     
     for (int i = 0; i < 3; i++) {
@@ -525,101 +566,114 @@ void DrawShop(const GameState* game) {
     }
     
     int contWidth = MeasureText(continueText, 25);
-    DrawRectangle(SCREEN_WIDTH / 2 - contWidth / 2 - 20, SCREEN_HEIGHT - 80, contWidth + 40, 50, buttonColor);
-    DrawRectangleLines(SCREEN_WIDTH / 2 - contWidth / 2 - 20, SCREEN_HEIGHT - 80, contWidth + 40, 50, game->shopContinuePressed ? ORANGE : GREEN);
-    DrawText(continueText, SCREEN_WIDTH / 2 - contWidth / 2, SCREEN_HEIGHT - 65, 25, WHITE);
+    DrawRectangle(screenWidth / 2 - contWidth / 2 - 20, screenHeight - 80, contWidth + 40, 50, buttonColor);
+    DrawRectangleLines(screenWidth / 2 - contWidth / 2 - 20, screenHeight - 80, contWidth + 40, 50, game->shopContinuePressed ? ORANGE : GREEN);
+    DrawText(continueText, screenWidth / 2 - contWidth / 2, screenHeight - 65, 25, WHITE);
     
     EndDrawing();
 }
 
-void DrawGameWon(const GameState* game) {
+void DrawGameWon(const RenderState* game) {
     BeginDrawing();
     ClearBackground(Color{10, 30, 10, 255});
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
+    int top = (screenHeight - DEFAULT_SCREEN_HEIGHT) / 2; // Center the layout vertically
     
     // Victory text
     const char* title = "YOU ESCAPED!";
     int titleWidth = MeasureText(title, 60);
-    DrawText(title, SCREEN_WIDTH / 2 - titleWidth / 2, 150, 60, GREEN);
+    DrawText(title, screenWidth / 2 - titleWidth / 2, top + 150, 60, GREEN);
     
     // Description
     const char* desc = "You successfully escaped the maze killer!";
     int descWidth = MeasureText(desc, 25);
-    DrawText(desc, SCREEN_WIDTH / 2 - descWidth / 2, 230, 25, WHITE);
+    DrawText(desc, screenWidth / 2 - descWidth / 2, top + 230, 25, WHITE);
     
     // Stats
-    DrawText(TextFormat("Levels Completed: %d", MAX_LEVELS), SCREEN_WIDTH / 2 - 120, 300, 22, YELLOW);
-    DrawText(TextFormat("Final Gold: $%d", game->totalGold), SCREEN_WIDTH / 2 - 100, 330, 22, GOLD);
-    DrawText(TextFormat("Final Speed: %.1f", game->player.baseSpeed), SCREEN_WIDTH / 2 - 100, 360, 22, SKYBLUE);
+    DrawText(TextFormat("Levels Completed: %d", MAX_LEVELS), screenWidth / 2 - 120, top + 300, 22, YELLOW);
+    DrawText(TextFormat("Final Gold: $%d", game->totalGold), screenWidth / 2 - 100, top + 330, 22, GOLD);
+    DrawText(TextFormat("Final Speed: %.1f", game->player.baseSpeed), screenWidth / 2 - 100, top + 360, 22, SKYBLUE);
     
     // Restart
     const char* restart = "Press R to restart";
     int restartWidth = MeasureText(restart, 30);
-    DrawText(restart, SCREEN_WIDTH / 2 - restartWidth / 2, 420, 30, LIGHTGRAY);
+    DrawText(restart, screenWidth / 2 - restartWidth / 2, top + 420, 30, LIGHTGRAY);
     
     // Game credits at bottom
     const char* gameTitle = "MazeKiller3D";
     int gameTitleWidth = MeasureText(gameTitle, 30);
-    DrawText(gameTitle, SCREEN_WIDTH / 2 - gameTitleWidth / 2, SCREEN_HEIGHT - 80, 30, Color{150, 255, 150, 255});
+    DrawText(gameTitle, screenWidth / 2 - gameTitleWidth / 2, screenHeight - 80, 30, Color{150, 255, 150, 255});
     
     const char* credits = "A Ludum Dare 58 Game";
     int creditsWidth = MeasureText(credits, 20);
-    DrawText(credits, SCREEN_WIDTH / 2 - creditsWidth / 2, SCREEN_HEIGHT - 45, 20, Color{100, 200, 100, 255});
+    DrawText(credits, screenWidth / 2 - creditsWidth / 2, screenHeight - 45, 20, Color{100, 200, 100, 255});
     
     EndDrawing();
 }
 
-void DrawGameLost(const GameState* game) {
+void DrawGameLost(const RenderState* game) {
     BeginDrawing();
     ClearBackground(Color{30, 10, 10, 255});
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
+    int top = (screenHeight - DEFAULT_SCREEN_HEIGHT) / 2; // Center the layout vertically
     
     // Game over text
     const char* title = "YOU DIED";
     int titleWidth = MeasureText(title, 70);
-    DrawText(title, SCREEN_WIDTH / 2 - titleWidth / 2, 150, 70, RED);
+    DrawText(title, screenWidth / 2 - titleWidth / 2, top + 150, 70, RED);
     
     // Description
     const char* desc = "You were stabbed by the maze killer...";
     int descWidth = MeasureText(desc, 25);
-    DrawText(desc, SCREEN_WIDTH / 2 - descWidth / 2, 240, 25, Color{200, 100, 100, 255});
+    DrawText(desc, screenWidth / 2 - descWidth / 2, top + 240, 25, Color{200, 100, 100, 255});
     
     // Stats
-    DrawText(TextFormat("Reached Level: %d/%d", game->currentLevel, MAX_LEVELS), SCREEN_WIDTH / 2 - 120, 320, 22, YELLOW);
-    DrawText(TextFormat("Gold Collected: $%d", game->totalGold), SCREEN_WIDTH / 2 - 120, 350, 22, GOLD);
+    DrawText(TextFormat("Reached Level: %d/%d", game->currentLevel, MAX_LEVELS), screenWidth / 2 - 120, top + 320, 22, YELLOW);
+    DrawText(TextFormat("Gold Collected: $%d", game->totalGold), screenWidth / 2 - 120, top + 350, 22, GOLD);
+    
+    // Retry or return to menu
+    const char* retryText = "Press R to retry this level";
+    int retryWidth = MeasureText(retryText, 28);
+    DrawText(retryText, screenWidth / 2 - retryWidth / 2, top + 410, 28, LIGHTGRAY);
     
-    // Return to menu
     const char* menuText = "Press SPACE to return to main menu";
     int menuWidth = MeasureText(menuText, 28);
-    DrawText(menuText, SCREEN_WIDTH / 2 - menuWidth / 2, 420, 28, LIGHTGRAY);
+    DrawText(menuText, screenWidth / 2 - menuWidth / 2, top + 450, 28, LIGHTGRAY);
     
     // Game credits at bottom
     const char* gameTitle = "MazeKiller3D";
     int gameTitleWidth = MeasureText(gameTitle, 30);
-    DrawText(gameTitle, SCREEN_WIDTH / 2 - gameTitleWidth / 2, SCREEN_HEIGHT - 80, 30, Color{255, 150, 150, 255});
+    DrawText(gameTitle, screenWidth / 2 - gameTitleWidth / 2, screenHeight - 80, 30, Color{255, 150, 150, 255});
     
     const char* credits = "A Ludum Dare 58 Game";
     int creditsWidth = MeasureText(credits, 20);
-    DrawText(credits, SCREEN_WIDTH / 2 - creditsWidth / 2, SCREEN_HEIGHT - 45, 20, Color{200, 100, 100, 255});
+    DrawText(credits, screenWidth / 2 - creditsWidth / 2, screenHeight - 45, 20, Color{200, 100, 100, 255});
     
     EndDrawing();
 }
 
-void DrawMainMenu(const GameState* game) {
+void DrawMainMenu(const RenderState* game) {
     BeginDrawing();
     ClearBackground(Color{10, 5, 5, 255});
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
+    int top = (screenHeight - DEFAULT_SCREEN_HEIGHT) / 2; // Center the layout vertically
     
     // Spooky background effect - dark red vignette
     for (int i = 0; i < 80; i++) {
         unsigned char alpha = (unsigned char)(i * 1.2f);
         DrawRectangleLinesEx(
-            Rectangle{(float)i, (float)i, (float)SCREEN_WIDTH - i*2, (float)SCREEN_HEIGHT - i*2},
+            Rectangle{(float)i, (float)i, (float)screenWidth - i*2, (float)screenHeight - i*2},
             1, Color{80, 0, 0, alpha}
         );
     }
     
     // Animated enemy figure in background
     float bobOffset = sinf(game->animTime * 1.5f) * 20.0f;
-    int enemyX = SCREEN_WIDTH / 2;
-    int enemyY = SCREEN_HEIGHT / 2 + 50 + (int)bobOffset;
+    int enemyX = screenWidth / 2;
+    int enemyY = screenHeight / 2 + 50 + (int)bobOffset;
     
     // Large shadowy enemy figure
     DrawCircle(enemyX, enemyY - 80, 60, Color{40, 0, 0, 150}); // Head
@@ -635,150 +689,75 @@ void DrawMainMenu(const GameState* game) {
     DrawLine(enemyX + 50, enemyY + 20, enemyX + 70, enemyY - 10, Color{200, 200, 200, 100});
     
     // Dark overlay for menu readability
-    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Color{0, 0, 0, 100});
+    DrawRectangle(0, 0, screenWidth, screenHeight, Color{0, 0, 0, 100});
     
     // Title with blood drip effect
     const char* title = "MazeKiller3D";
     int titleWidth = MeasureText(title, 80);
-    DrawText(title, SCREEN_WIDTH / 2 - titleWidth / 2 + 2, 122, 80, Color{80, 0, 0, 255}); // Shadow
-    DrawText(title, SCREEN_WIDTH / 2 - titleWidth / 2, 120, 80, Color{200, 0, 0, 255}); // Dark red
+    DrawText(title, screenWidth / 2 - titleWidth / 2 + 2, top + 122, 80, Color{80, 0, 0, 255}); // Shadow
+    DrawText(title, screenWidth / 2 - titleWidth / 2, top + 120, 80, Color{200, 0, 0, 255}); // Dark red
     
     // Subtitle
     const char* subtitle = "A Ludum Dare 58 Game";
     int subtitleWidth = MeasureText(subtitle, 25);
-    DrawText(subtitle, SCREEN_WIDTH / 2 - subtitleWidth / 2, 210, 25, Color{150, 50, 50, 255});
+    DrawText(subtitle, screenWidth / 2 - subtitleWidth / 2, top + 210, 25, Color{150, 50, 50, 255});
     
     // Menu options with spooky style
     const char* startText = "Start Game";
     const char* exitText = "Exit";
     
-    int startY = 300;
+    int startY = top + 300;
     int spacing = 60;
     
     // Start button
     Color startColor = game->menuSelection == 0 ? Color{255, 200, 0, 255} : Color{200, 150, 150, 255};
     int startWidth = MeasureText(startText, 40);
     if (game->menuSelection == 0) {
-        DrawRectangle(SCREEN_WIDTH / 2 - startWidth / 2 - 20, startY - 10, startWidth + 40, 50, Color{80, 0, 0, 150});
-        DrawRectangleLines(SCREEN_WIDTH / 2 - startWidth / 2 - 20, startY - 10, startWidth + 40, 50, Color{200, 0, 0, 255});
-        DrawText(">", SCREEN_WIDTH / 2 - startWidth / 2 - 50, startY, 40, Color{255, 200, 0, 255});
+        DrawRectangle(screenWidth / 2 - startWidth / 2 - 20, startY - 10, startWidth + 40, 50, Color{80, 0, 0, 150});
+        DrawRectangleLines(screenWidth / 2 - startWidth / 2 - 20, startY - 10, startWidth + 40, 50, Color{200, 0, 0, 255});
+        DrawText(">", screenWidth / 2 - startWidth / 2 - 50, startY, 40, Color{255, 200, 0, 255});
     }
-    DrawText(startText, SCREEN_WIDTH / 2 - startWidth / 2, startY, 40, startColor);
+    DrawText(startText, screenWidth / 2 - startWidth / 2, startY, 40, startColor);
     
     // Exit button
     Color exitColor = game->menuSelection == 1 ? Color{255, 200, 0, 255} : Color{200, 150, 150, 255};
     int exitWidth = MeasureText(exitText, 40);
     if (game->menuSelection == 1) {
-        DrawRectangle(SCREEN_WIDTH / 2 - exitWidth / 2 - 20, startY + spacing - 10, exitWidth + 40, 50, Color{80, 0, 0, 150});
-        DrawRectangleLines(SCREEN_WIDTH / 2 - exitWidth / 2 - 20, startY + spacing - 10, exitWidth + 40, 50, Color{200, 0, 0, 255});
-        DrawText(">", SCREEN_WIDTH / 2 - exitWidth / 2 - 50, startY + spacing, 40, Color{255, 200, 0, 255});
+        DrawRectangle(screenWidth / 2 - exitWidth / 2 - 20, startY + spacing - 10, exitWidth + 40, 50, Color{80, 0, 0, 150});
+        DrawRectangleLines(screenWidth / 2 - exitWidth / 2 - 20, startY + spacing - 10, exitWidth + 40, 50, Color{200, 0, 0, 255});
+        DrawText(">", screenWidth / 2 - exitWidth / 2 - 50, startY + spacing, 40, Color{255, 200, 0, 255});
     }
-    DrawText(exitText, SCREEN_WIDTH / 2 - exitWidth / 2, startY + spacing, 40, exitColor);
+    DrawText(exitText, screenWidth / 2 - exitWidth / 2, startY + spacing, 40, exitColor);
     
     // Controls
     const char* controls = "Use W/S or Arrow Keys to navigate | ENTER or SPACE to select";
     int controlsWidth = MeasureText(controls, 18);
-    DrawText(controls, SCREEN_WIDTH / 2 - controlsWidth / 2, SCREEN_HEIGHT - 100, 18, Color{100, 50, 50, 255});
+    DrawText(controls, screenWidth / 2 - controlsWidth / 2, screenHeight - 100, 18, Color{100, 50, 50, 255});
     
     // Game description
     const char* desc = "Collect gold, avoid the killer, escape the maze!";
     int descWidth = MeasureText(desc, 22);
-    DrawText(desc, SCREEN_WIDTH / 2 - descWidth / 2, SCREEN_HEIGHT - 60, 22, Color{150, 100, 100, 255});
+    DrawText(desc, screenWidth / 2 - descWidth / 2, screenHeight - 60, 22, Color{150, 100, 100, 255});
     
     EndDrawing();
 }
 
-void DrawGame(const GameState* game) {
-    if (game->mode == MAIN_MENU) {
-        DrawMainMenu(game);
-        return;
-    }
-    
-    if (game->mode == LOADING) {
-        DrawLoadingScreen(game->loadingTimer / 1.5f);
-        return;
-    }
+// Cast one ray per screen column into hits, draw the walls and fill
+// depthBuffer; cells the rays cross are marked visible
+static void DrawWalls(const RenderState* game, Vector2 viewPos, float viewAngle, int screenWidth, int screenHeight,
+                      float focalLength, RayHit* hits, float* depthBuffer) {
+    CastRays(viewPos, viewAngle, game->FOV, screenWidth, hits, &visibleCells);
     
-    if (game->mode == SHOP) {
-        DrawShop(game);
-        return;
-    }
-    
-    if (game->mode == GAME_WON) {
-        DrawGameWon(game);
-        return;
-    }
-    
-    if (game->mode == GAME_LOST) {
-        DrawGameLost(game);
-        return;
-    }
-    
-    // PLAYING mode
-    BeginDrawing();
-    ClearBackground(BLACK);
-    
-    // Dark ceiling/floor
-    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT/2, Color{30, 20, 30, 255});
-    DrawRectangle(0, SCREEN_HEIGHT/2, SCREEN_WIDTH, SCREEN_HEIGHT/2, Color{40, 30, 30, 255});
-    
-    // Depth buffer for sprite occlusion
-    float depthBuffer[SCREEN_WIDTH];
-    
-    Vector2 dirVec = { cosf(game->player.angle), sinf(game->player.angle) };
-    
-    // Raycasting
-    for (int x = 0; x < SCREEN_WIDTH; x++) {
-        float cameraX = 2.0f * x / (float)SCREEN_WIDTH - 1.0f;
-        float rayAngle = game->player.angle + atanf(cameraX * tanf(game->FOV / 2.0f));
-        
-        Vector2 rayDir = { cosf(rayAngle), sinf(rayAngle) };
-        
-        int mapX = (int)game->player.position.x;
-        int mapY = (int)game->player.position.y;
-        
-        float deltaDistX = (rayDir.x == 0) ? 1e30f : fabsf(1.0f / rayDir.x);
-        float deltaDistY = (rayDir.y == 0) ? 1e30f : fabsf(1.0f / rayDir.y);
-        
-        int stepX = (rayDir.x < 0) ? -1 : 1;
-        int stepY = (rayDir.y < 0) ? -1 : 1;
-        
-        float sideDistX = (rayDir.x < 0) 
-            ? (game->player.position.x - mapX) * deltaDistX 
-            : (mapX + 1.0f - game->player.position.x) * deltaDistX;
-        float sideDistY = (rayDir.y < 0) 
-            ? (game->player.position.y - mapY) * deltaDistY 
-            : (mapY + 1.0f - game->player.position.y) * deltaDistY;
+    for (int x = 0; x < screenWidth; x++) {
+        float perpWallDist = hits[x].distance;
+        bool side = hits[x].side;
         
-        bool hit = false;
-        bool side = false;
+        int lineHeight = (int)(focalLength / perpWallDist);
         
-        while (!hit) {
-            if (sideDistX < sideDistY) {
-                sideDistX += deltaDistX;
-                mapX += stepX;
-                side = false;
-            } else {
-                sideDistY += deltaDistY;
-                mapY += stepY;
-                side = true;
-            }
-            
-            int tile = GetMapTile(mapX, mapY);
-            if (tile > 0) hit = true;
-        }
-        
-        float perpWallDist = !side 
-            ? (mapX - game->player.position.x + (float)(1 - stepX) / 2) / rayDir.x 
-            : (mapY - game->player.position.y + (float)(1 - stepY) / 2) / rayDir.y;
-        if (perpWallDist < 0.1f) perpWallDist = 0.1f;
-        
-        int lineHeight = (int)(SCREEN_HEIGHT / perpWallDist);
-        
-        int drawStart = -lineHeight / 2 + SCREEN_HEIGHT / 2;
+        int drawStart = -lineHeight / 2 + screenHeight / 2;
         if (drawStart < 0) drawStart = 0;
-        int drawEnd = lineHeight / 2 + SCREEN_HEIGHT / 2;
-        if (drawEnd >= SCREEN_HEIGHT) drawEnd = SCREEN_HEIGHT - 1;
+        int drawEnd = lineHeight / 2 + screenHeight / 2;
+        if (drawEnd >= screenHeight) drawEnd = screenHeight - 1;
         
         Color baseColor = side ? Color{80, 50, 50, 255} : Color{120, 70, 70, 255};
         
@@ -787,7 +766,7 @@ void DrawGame(const GameState* game) {
         if (fogFactor > 1.0f) fogFactor = 1.0f;
         
         Color wallColor;
-        int tile = GetMapTile(mapX, mapY);
+        int tile = hits[x].tile;
         bool isDoor = tile == 2;
         bool canAffordDoor = game->totalGold >= game->doorCost;
         
@@ -807,38 +786,33 @@ void DrawGame(const GameState* game) {
                 255
             };
         }
-
+        
         depthBuffer[x] = perpWallDist;
         
         if (!(isDoor && canAffordDoor)) {
             DrawLine(x, drawStart, x, drawEnd, wallColor);
         }
         
-        if (isDoor && !canAffordDoor && x == SCREEN_WIDTH / 2) {
+        if (isDoor && !canAffordDoor && x == screenWidth / 2) {
             Color textColor = canAffordDoor ? GREEN : RED;
             int textY = drawStart - 20;
             if (textY < 50) textY = 50;
             const char* doorText = TextFormat("$%d", game->doorCost);
             int textWidth = MeasureText(doorText, 14);
-            DrawText(doorText, SCREEN_WIDTH / 2 - textWidth / 2, textY, 14, textColor);
+            DrawText(doorText, screenWidth / 2 - textWidth / 2, textY, 14, textColor);
         }
     }
+}
 
-    // Draw enemy
-    DrawEnemy(&game->enemy, game->player.position, dirVec, depthBuffer, SCREEN_WIDTH, SCREEN_HEIGHT);
-    
-    // Draw collectibles
-    DrawCollectibles(game->collectibles, game->player.position, dirVec, game->animTime, 
-                    depthBuffer, SCREEN_WIDTH, SCREEN_HEIGHT);
-    
-    // Minimap
+static void DrawMinimap(const RenderState* game, Vector2 viewPos, Vector2 dirVec, float alpha) {
     const int miniMapScale = 6;
     const int miniMapOffsetX = 10;
     const int miniMapOffsetY = 10;
+    MapView map = GetCurrentMapView();
     
-    for (int y = 0; y < currentMapHeight; y++) {
-        for (int x = 0; x < currentMapWidth; x++) {
-            int tile = GetMapTile(x, y);
+    for (int y = 0; y < map.height; y++) {
+        for (int x = 0; x < map.width; x++) {
+            int tile = GetMapTile(map, x, y);
             Color color = tile == 1 ? WHITE : tile == 2 ? RED : BLACK;
             DrawRectangle(
                 miniMapOffsetX + x * miniMapScale, 
@@ -852,64 +826,169 @@ void DrawGame(const GameState* game) {
     
     // Enemy on minimap (only if radar purchased)
     if (game->showEnemyOnMinimap && game->enemy.isActive) {
+        Vector2 enemyPos = Vector2Lerp(game->enemy.prevPosition, game->enemy.position, alpha);
         DrawCircle(
-            miniMapOffsetX + (int)(game->enemy.position.x * miniMapScale),
-            miniMapOffsetY + (int)(game->enemy.position.y * miniMapScale),
+            miniMapOffsetX + (int)(enemyPos.x * miniMapScale),
+            miniMapOffsetY + (int)(enemyPos.y * miniMapScale),
             3, Color{150, 0, 0, 255}
         );
     }
     
     // Player on minimap
     DrawCircle(
-        miniMapOffsetX + (int)(game->player.position.x * miniMapScale),
-        miniMapOffsetY + (int)(game->player.position.y * miniMapScale),
+        miniMapOffsetX + (int)(viewPos.x * miniMapScale),
+        miniMapOffsetY + (int)(viewPos.y * miniMapScale),
         2, GREEN
     );
     
     DrawLine(
-        miniMapOffsetX + (int)(game->player.position.x * miniMapScale),
-        miniMapOffsetY + (int)(game->player.position.y * miniMapScale),
-        miniMapOffsetX + (int)((game->player.position.x + dirVec.x * 0.5f) * miniMapScale),
-        miniMapOffsetY + (int)((game->player.position.y + dirVec.y * 0.5f) * miniMapScale),
+        miniMapOffsetX + (int)(viewPos.x * miniMapScale),
+        miniMapOffsetY + (int)(viewPos.y * miniMapScale),
+        miniMapOffsetX + (int)((viewPos.x + dirVec.x * 0.5f) * miniMapScale),
+        miniMapOffsetY + (int)((viewPos.y + dirVec.y * 0.5f) * miniMapScale),
         GREEN
     );
-    
+}
+
+// Vignette, stab effect and on-screen text
+static void DrawHud(const RenderState* game) {
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
     // Vignette effect
     for (int i = 0; i < 60; i++) {
         unsigned char alpha = (unsigned char)(i * 2);
         DrawRectangleLinesEx(
-            Rectangle{(float)i, (float)i, (float)SCREEN_WIDTH - i*2, (float)SCREEN_HEIGHT - i*2}, 
+            Rectangle{(float)i, (float)i, (float)screenWidth - i*2, (float)screenHeight - i*2}, 
             1, Color{0, 0, 0, alpha}
         );
     }
-
+    
     // Draw stab effect if being attacked
     if (game->isBeingAttacked && game->stabEffectTimer > 0) {
         float intensity = game->stabEffectTimer / 2.0f;
         DrawStabEffect(intensity);
     }
-
+    
     // TOP UI: Goal
     const char* goalText = TextFormat("GOAL: Collect $%d to unlock door", game->doorCost);
     int goalWidth = MeasureText(goalText, 24);
-    DrawRectangle(SCREEN_WIDTH / 2 - goalWidth / 2 - 15, 10, goalWidth + 30, 40, Color{0, 0, 0, 180});
+    DrawRectangle(screenWidth / 2 - goalWidth / 2 - 15, 10, goalWidth + 30, 40, Color{0, 0, 0, 180});
     Color goalColor = game->totalGold >= game->doorCost ? GREEN : ORANGE;
-    DrawText(goalText, SCREEN_WIDTH / 2 - goalWidth / 2, 18, 24, goalColor);
+    DrawText(goalText, screenWidth / 2 - goalWidth / 2, 18, 24, goalColor);
     
     // RIGHT UI: Gold
-    DrawRectangle(SCREEN_WIDTH - 150, 60, 140, 50, Color{0, 0, 0, 180});
-    DrawRectangleLines(SCREEN_WIDTH - 150, 60, 140, 50, GOLD);
-    DrawText(TextFormat("Gold: $%d", game->totalGold), SCREEN_WIDTH - 140, 75, 25, GOLD);
+    DrawRectangle(screenWidth - 150, 60, 140, 50, Color{0, 0, 0, 180});
+    DrawRectangleLines(screenWidth - 150, 60, 140, 50, GOLD);
+    DrawText(TextFormat("Gold: $%d", game->totalGold), screenWidth - 140, 75, 25, GOLD);
     
     // Speed boost indicator
     if (game->player.hasSpeedBoost) {
-        DrawRectangle(SCREEN_WIDTH - 150, 120, 140, 40, Color{0, 0, 255, 180});
-        DrawRectangleLines(SCREEN_WIDTH - 150, 120, 140, 40, BLUE);
-        DrawText(TextFormat("BOOST: %.1fs", game->player.boostTimer), SCREEN_WIDTH - 140, 130, 20, BLUE);
+        DrawRectangle(screenWidth - 150, 120, 140, 40, Color{0, 0, 255, 180});
+        DrawRectangleLines(screenWidth - 150, 120, 140, 40, BLUE);
+        DrawText(TextFormat("BOOST: %.1fs", game->player.boostTimer), screenWidth - 140, 130, 20, BLUE);
+    }
+    
+    DrawFPS(10, screenHeight - 30);
+    DrawText(TextFormat("Level %d/%d", game->currentLevel, MAX_LEVELS), 10, screenHeight - 50, 20, WHITE);
+}
+
+void DrawGame(const RenderState* game, float alpha, float lateYaw) {
+    TRACE_SCOPE("DrawGame");
+    if (game->mode == MAIN_MENU) {
+        DrawMainMenu(game);
+        return;
+    }
+    
+    if (game->mode == LOADING) {
+        DrawLoadingScreen(game->loadProgress);
+        return;
+    }
+    
+    if (game->mode == SHOP) {
+        DrawShop(game);
+        return;
+    }
+    
+    if (game->mode == GAME_WON) {
+        DrawGameWon(game);
+        return;
     }
     
-    DrawFPS(10, SCREEN_HEIGHT - 30);
-    DrawText(TextFormat("Level %d/%d", game->currentLevel, MAX_LEVELS), 10, SCREEN_HEIGHT - 50, 20, WHITE);
+    if (game->mode == GAME_LOST) {
+        DrawGameLost(game);
+        return;
+    }
+    
+    // PLAYING mode, on whichever thread renders
+    SetCurrentMap(game->map, game->mapWidth, game->mapHeight);
+    int screenWidth = GetScreenWidth();
+    int screenHeight = GetScreenHeight();
+    
+    // Ray hits and depth (for sprite occlusion) per column, reallocated only
+    // when the window width changes
+    if ((int)depthBuffer.size() != screenWidth) {
+        columnHits.resize(screenWidth);
+        depthBuffer.resize(screenWidth);
+    }
+    
+    BeginDrawing();
+    ClearBackground(BLACK);
+    
+    // Dark ceiling/floor
+    DrawRectangle(0, 0, screenWidth, screenHeight/2, Color{30, 20, 30, 255});
+    DrawRectangle(0, screenHeight/2, screenWidth, screenHeight/2, Color{40, 30, 30, 255});
+    
+    // Interpolated view between the last two simulation ticks
+    Vector2 viewPos = Vector2Lerp(game->player.prevPosition, game->player.position, alpha);
+    float viewAngle = Lerp(game->player.prevAngle, game->player.angle, alpha) + lateYaw;
+    
+    Vector2 dirVec = { cosf(viewAngle), sinf(viewAngle) };
+    float focalLength = GetFocalLength(game->FOV, screenWidth);
+    
+    BeginVisibleCells(&visibleCells);
+    MarkVisibleCell(&visibleCells, (int)viewPos.x, (int)viewPos.y, currentMapWidth, currentMapHeight);
+    
+    // Raycasting
+    {
+        PROFILE_SCOPE(PHASE_RAYCAST);
+        TRACE_SCOPE("Raycast");
+        DrawWalls(game, viewPos, viewAngle, screenWidth, screenHeight, focalLength, columnHits.data(), depthBuffer.data());
+    }
+    
+    // Sprites come from one premultiplied atlas, so they batch into a few draw calls
+    {
+        PROFILE_SCOPE(PHASE_SPRITES);
+        TRACE_SCOPE("Sprites");
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        
+        // Draw enemy
+        DrawEnemy(&game->enemy, game->sprites, alpha, viewPos, dirVec, depthBuffer.data(), screenWidth, screenHeight,
+                  focalLength);
+        
+        // Draw collectibles
+        GrowVisibleCells(&visibleCells);
+        DrawCollectibles(game->collectibles, game->sprites, visibleCells.cells.data(), (int)visibleCells.cells.size(),
+                        viewPos, dirVec, game->animTime, depthBuffer.data(), screenWidth, screenHeight, focalLength);
+        
+        EndBlendMode();
+    }
+    
+    // Minimap
+    {
+        PROFILE_SCOPE(PHASE_MINIMAP);
+        DrawMinimap(game, viewPos, dirVec, alpha);
+    }
+    
+    {
+        PROFILE_SCOPE(PHASE_HUD);
+        DrawHud(game);
+    }
+    
+    if (profilerEnabled) {
+        DrawProfilerOverlay(screenWidth - 10, screenHeight - 10);
+    }
     
+    PROFILE_SCOPE(PHASE_PRESENT);
+    TRACE_SCOPE("EndDrawing");
     EndDrawing();
 }
@@ -5,11 +5,25 @@
 #include <vector>
 #include "collectible.h"
 #include "enemy.h"
-
-const int SCREEN_WIDTH = 1280;
-const int SCREEN_HEIGHT = 720;
+#include "level.h"
+#include "rng.h"
+#include "audio.h"
+#include "snapshot.h"
+
+// Window size at startup. The window can be resized: rendering and UI
+// layout follow its current size, with one ray cast per pixel column.
+const int DEFAULT_SCREEN_WIDTH = 1280;
+const int DEFAULT_SCREEN_HEIGHT = 720;
+const int MIN_SCREEN_WIDTH = 800;  // Smallest size the menus and shop fit in
+const int MIN_SCREEN_HEIGHT = 600;
 const int MAX_LEVELS = 5;
 
+// Fixed-step simulation
+const float SIM_TICK_RATE = 120.0f;
+const float SIM_DT = 1.0f / SIM_TICK_RATE;
+const float MAX_FRAME_TIME = 0.25f;    // Longer frames are clamped (spiral-of-death guard)
+const int MAX_SIM_STEPS_PER_FRAME = 16;
+
 enum GameMode {
     MAIN_MENU,
     PLAYING,
@@ -27,9 +41,28 @@ struct Perk {
     float value;
 };
 
+// Input sampled once per rendered frame. Held keys are a snapshot; pressed
+// edges and mouse look accumulate until a simulation tick consumes them.
+struct GameInput {
+    bool moveForward;
+    bool moveBack;
+    bool moveLeft;
+    bool moveRight;
+    float lookDelta;      // Horizontal mouse movement not yet applied
+    bool upPressed;       // W / Up
+    bool downPressed;     // S / Down
+    bool enterPressed;
+    bool spacePressed;
+    bool restartPressed;  // R
+    bool perkPressed[3];  // 1 / 2 / 3
+    bool levelReady;      // Background level build done, sampled per tick (recorded in replays)
+};
+
 struct Player {
     Vector2 position;
+    Vector2 prevPosition; // Pose at the previous tick, for render interpolation
     float angle;
+    float prevAngle;
     float moveSpeed;
     float mouseSensitivity;
     bool hasSpeedBoost;
@@ -40,7 +73,7 @@ struct Player {
 
 struct GameState {
     Player player;
-    std::vector<Collectible> collectibles;
+    CollectibleStore collectibles;
     Enemy enemy;
     int totalGold;
     float animTime;
@@ -48,7 +81,6 @@ struct GameState {
     int doorCost;
     int currentLevel;
     GameMode mode;
-    float loadingTimer;
     Perk shopPerks[3];
     int selectedPerk;
     float stabEffectTimer;
@@ -56,45 +88,92 @@ struct GameState {
     bool shopContinuePressed;
     int menuSelection;
     bool showEnemyOnMinimap;
-    Sound collectSound;
-    Sound stabSound;
-    Sound purchaseSound;
-    Sound jumpscareSound;
-    Music horrorMusic;
+    bool jumpscareLooping; // Last loop state posted to the audio thread
+    SpriteAtlas sprites;
+    Rng rng;             // Shop rolls and level seeds
+    LevelLoader loader;  // Next level, built in the background
+    bool foregroundLoads; // Build levels only on entry, never in the background (batch play)
+    GameSnapshot levelStart; // Taken as each level starts, for retry after dying
+};
+
+// What rendering reads, copied out of GameState after a tick so drawing never
+// touches live simulation state and can run on another thread
+struct RenderState {
+    GameMode mode;
+    Player player;
+    Enemy enemy;                   // Pose and isActive only; no path or planner
+    CollectibleStore collectibles;
+    const int* map;                // Map current on the simulating thread
+    int mapWidth;
+    int mapHeight;
+    const SpriteAtlas* sprites;
+    float animTime;
+    float FOV;
+    int totalGold;
+    int doorCost;
+    int currentLevel;
+    Perk shopPerks[3];
+    int selectedPerk;
+    bool shopContinuePressed;
+    int menuSelection;
+    float stabEffectTimer;
+    bool isBeingAttacked;
+    bool showEnemyOnMinimap;
+    float loadProgress;
+    double tickTime;               // Threaded mode: SimClock time of the tick, for interpolation
+    double lookApplied;            // Threaded mode: total mouse look consumed by this tick
 };
 
-// Initialize game state
+// Initialize game state. game->rng must already be seeded; it keeps running
+// across restarts so a whole session follows from one seed. Doesn't touch
+// game->sprites (load those once after InitWindow), so it runs headless.
 void InitGame(GameState* game);
 
-// Initialize level
+// Start a level, swapping in the background-built data when it is ready
 void InitLevel(GameState* game, int level);
 
 // Generate shop perks
 void GenerateShopPerks(GameState* game);
 
-// Update game logic
-void UpdateGame(GameState* game, float deltaTime);
+// Fill in a perk's name and description from its type
+void DescribePerk(Perk* perk);
+
+// Sample keyboard and mouse into input (call once per rendered frame)
+void PollGameInput(GameInput* input);
+
+// Clear pressed edges and mouse look after a tick has consumed them
+void ConsumeGameInput(GameInput* input);
+
+// Advance game logic by one fixed step
+void UpdateGame(GameState* game, const GameInput* input, float deltaTime);
+
+// Copy what rendering needs from game into state (no allocation once the
+// state's buffers have grown to the level's size)
+void CaptureRenderState(const GameState* game, RenderState* state);
 
-// Render game
-void DrawGame(const GameState* game);
+// Render a captured state, interpolating alpha (0..1) between the previous
+// and current tick. lateYaw (radians) is mouse look sampled after the last
+// tick, added to the view so it shows before a tick has applied it. Makes the
+// state's map current on the calling thread.
+void DrawGame(const RenderState* game, float alpha, float lateYaw);
 
 // Draw loading screen
 void DrawLoadingScreen(float progress);
 
 // Draw shop UI
-void DrawShop(const GameState* game);
+void DrawShop(const RenderState* game);
 
 // Draw game won screen
-void DrawGameWon(const GameState* game);
+void DrawGameWon(const RenderState* game);
 
 // Draw game lost screen
-void DrawGameLost(const GameState* game);
+void DrawGameLost(const RenderState* game);
 
 // Draw knife stab effect
 void DrawStabEffect(float intensity);
 
 // Draw main menu
-void DrawMainMenu(const GameState* game);
+void DrawMainMenu(const RenderState* game);
 
 #endif
 
@@ -0,0 +1,169 @@
+#include "level.h"
+#include "map.h"
+#include "rng.h"
+#include "trace.h"
+#include <utility>
+
+static void SetProgress(std::atomic<float>* progress, float value) {
+    if (progress) progress->store(value, std::memory_order_relaxed);
+}
+
+// Bundled levels, in order
+struct LevelLayout {
+    const int* map;
+    int width;
+    int height;
+    Vector2 playerStart;
+    int doorCost;
+};
+
+static const LevelLayout levelLayouts[] = {
+    { (const int*)worldMap1, MAP_WIDTH, MAP_HEIGHT, { 8.0f, 8.0f }, 50 },
+    { (const int*)worldMap2, MAP_WIDTH_2, MAP_HEIGHT_2, { 10.0f, 10.0f }, 80 },
+    { (const int*)worldMap3, MAP_WIDTH_2, MAP_HEIGHT_2, { 10.0f, 10.0f }, 120 },
+    { (const int*)worldMap4, MAP_WIDTH_2, MAP_HEIGHT_2, { 10.0f, 10.0f }, 150 },
+    { (const int*)worldMap5, MAP_WIDTH_2, MAP_HEIGHT_2, { 10.0f, 10.0f }, 200 },
+};
+const int LEVEL_LAYOUT_COUNT = sizeof(levelLayouts) / sizeof(levelLayouts[0]);
+
+// Levels past the last one reuse it
+static const LevelLayout& GetLevelLayout(int level) {
+    if (level >= 1 && level < LEVEL_LAYOUT_COUNT) return levelLayouts[level - 1];
+    return levelLayouts[LEVEL_LAYOUT_COUNT - 1];
+}
+
+const int* GetLevelMap(int level, int* width, int* height) {
+    const LevelLayout& layout = GetLevelLayout(level);
+    *width = layout.width;
+    *height = layout.height;
+    return layout.map;
+}
+
+void BuildLevel(LevelData* data, int level, unsigned int seed, std::atomic<float>* progress) {
+    TRACE_SCOPE("BuildLevel");
+    data->level = level;
+    SetProgress(progress, 0.0f);
+    
+    // Map, start and door cost based on level
+    const LevelLayout& layout = GetLevelLayout(level);
+    data->map = layout.map;
+    data->mapWidth = layout.width;
+    data->mapHeight = layout.height;
+    data->playerStart = layout.playerStart;
+    data->doorCost = layout.doorCost;
+    
+    // Generation code reads this thread's current map
+    SetCurrentMap(data->map, data->mapWidth, data->mapHeight);
+    SetProgress(progress, 0.1f);
+    
+    Rng rng;
+    SeedRng(&rng, seed);
+    InitCollectibles(data->collectibles, level, data->playerStart, &rng);
+    SetProgress(progress, 0.8f);
+    
+    InitEnemy(&data->enemy, data->playerStart, data->mapWidth, data->mapHeight, level);
+    SetProgress(progress, 0.9f);
+    
+    // Plan the enemy's first path now: the first tick would plan the same
+    // one (the player hasn't moved yet), but here it's off the main thread
+    if (data->enemy.isActive) {
+        PlanPath(&data->enemy.planner, data->enemy.position, data->playerStart, data->enemy.path);
+        data->enemy.currentPathIndex = 0;
+        data->enemy.pathRecalcTimer = 0.5f;
+    }
+    SetProgress(progress, 1.0f);
+}
+
+// Rebind the loader's data to the spare arena, then empty it. Nothing else
+// points into the spare: it held the level before the one in play.
+static void PrepareSpareArena(LevelLoader* loader) {
+    Arena* spare = &loader->arenas[1 - loader->liveArena];
+    SetCollectibleArena(loader->data.collectibles, spare);
+    SetEnemyArena(&loader->data.enemy, spare);
+    ResetArena(spare);
+}
+
+// Worker loop: build each queued level, then wait for the next
+static void RunLevelLoader(LevelLoader* loader) {
+    SetTraceThreadName("level loader");
+    std::unique_lock<std::mutex> lock(loader->mutex);
+    while (true) {
+        loader->requested.wait(lock, [loader]() { return loader->busy || loader->quit; });
+        if (loader->quit) return;
+        int level = loader->level;
+        unsigned int seed = loader->seed;
+        lock.unlock();
+        
+        BuildLevel(&loader->data, level, seed, &loader->progress);
+        loader->ready.store(true, std::memory_order_release);
+        
+        lock.lock();
+        loader->busy = false;
+        loader->finished.notify_all();
+    }
+}
+
+static void WaitForLevelLoader(LevelLoader* loader) {
+    std::unique_lock<std::mutex> lock(loader->mutex);
+    loader->finished.wait(lock, [loader]() { return !loader->busy; });
+}
+
+void StartLevelLoad(LevelLoader* loader, int level, unsigned int seed) {
+    CancelLevelLoad(loader);
+    
+    PrepareSpareArena(loader);
+    loader->progress.store(0.0f);
+    loader->ready.store(false);
+    {
+        std::lock_guard<std::mutex> lock(loader->mutex);
+        loader->level = level;
+        loader->seed = seed;
+        loader->busy = true;
+    }
+    if (!loader->worker.joinable()) {
+        loader->worker = std::thread(RunLevelLoader, loader);
+    }
+    loader->requested.notify_one();
+}
+
+void BuildLevelNow(LevelLoader* loader, int level, unsigned int seed) {
+    CancelLevelLoad(loader);
+    
+    PrepareSpareArena(loader);
+    BuildLevel(&loader->data, level, seed, nullptr);
+    loader->level = level;
+    loader->progress.store(1.0f);
+    loader->ready.store(true);
+}
+
+float GetLevelLoadProgress(const LevelLoader* loader) {
+    if (loader->level == 0) return 1.0f;
+    return loader->progress.load(std::memory_order_relaxed);
+}
+
+bool IsLevelLoadReady(const LevelLoader* loader, int level) {
+    return loader->level == level && loader->ready.load(std::memory_order_acquire);
+}
+
+void TakeLoadedLevel(LevelLoader* loader, LevelData* data) {
+    WaitForLevelLoader(loader);
+    std::swap(*data, loader->data);
+    loader->liveArena = 1 - loader->liveArena;
+    loader->level = 0;
+}
+
+void CancelLevelLoad(LevelLoader* loader) {
+    WaitForLevelLoader(loader);
+    loader->level = 0;
+}
+
+LevelLoader::~LevelLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    requested.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include <raylib.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "collectible.h"
+#include "enemy.h"
+#include "arena.h"
+
+// Everything a level needs before play starts. Its containers allocate from
+// the level arena it was built in.
+struct LevelData {
+    int level;
+    const int* map;
+    int mapWidth;
+    int mapHeight;
+    Vector2 playerStart;
+    int doorCost;
+    CollectibleStore collectibles; // Placed, with their pickup grid built
+    Enemy enemy;                   // Spawned, planner reset
+};
+
+// Builds one LevelData on a worker thread while the main loop keeps running.
+// Level arenas are double-buffered: the level in play lives in one, the next
+// is built in the other, and taking a level swaps their roles. Building
+// resets the spare arena, so a finished level's memory goes in one step. The
+// worker starts with the first background load and then waits for the next
+// one, so its scratch arena and trace ring are reused across loads.
+struct LevelLoader {
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable requested; // A load or quit for the worker
+    std::condition_variable finished;  // The worker went idle
+    bool busy = false;                 // Worker has a load queued or running
+    bool quit = false;
+    unsigned int seed = 0;             // Of the queued load
+    std::atomic<float> progress;       // 0..1, written by the worker
+    std::atomic<bool> ready;           // Set once data is complete
+    int level;                         // Level being built, 0 if none
+    LevelData data;
+    Arena arenas[2];
+    int liveArena;                     // Arena of the level in play
+    
+    ~LevelLoader(); // Stops the worker
+};
+
+// Bundled map for a level (levels past the last reuse it)
+const int* GetLevelMap(int level, int* width, int* height);
+
+// Build a level on the calling thread, allocating from whichever arena data's
+// containers use (the heap for fresh ones). Only touches the calling thread's
+// current map, so it is safe off the main thread. progress may be null.
+void BuildLevel(LevelData* data, int level, unsigned int seed, std::atomic<float>* progress);
+
+// Start building a level in the background (waits out any previous load)
+void StartLevelLoad(LevelLoader* loader, int level, unsigned int seed);
+
+// Build a level right away on the calling thread, ready to take
+void BuildLevelNow(LevelLoader* loader, int level, unsigned int seed);
+
+// Progress of the running load (1 when idle)
+float GetLevelLoadProgress(const LevelLoader* loader);
+
+// True once the level started with StartLevelLoad can be taken
+bool IsLevelLoadReady(const LevelLoader* loader, int level);
+
+// Wait for the worker and swap the finished level into data. The previous
+// level's arena becomes the spare, so data's old contents must be dropped
+// before the next load starts.
+void TakeLoadedLevel(LevelLoader* loader, LevelData* data);
+
+// Wait for any running load and drop its result
+void CancelLevelLoad(LevelLoader* loader);
+
+#endif
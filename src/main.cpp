@@ -1,43 +1,240 @@
 #include <raylib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "game.h"
+#include "replay.h"
+#include "profiler.h"
+#include "framepacer.h"
+#include "simthread.h"
+#include "trace.h"
 
-int main() {
-    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "MazeKiller3D - LD58");
-    SetTargetFPS(60);
+// F3 toggles the profiler overlay, F4 dumps its history, F5 starts a trace
+// capture and, pressed again, writes it to trace.json, F6 toggles hardware
+// counters in the profiler
+static void HandleProfilerKeys() {
+    if (IsKeyPressed(KEY_F3)) SetProfilerEnabled(!profilerEnabled);
+    if (IsKeyPressed(KEY_F4) && profilerEnabled) WriteProfileCsv("profile.csv");
+    if (IsKeyPressed(KEY_F6)) SetProfilerCounters(!profilerCounters);
+    if (IsKeyPressed(KEY_F5)) {
+        if (traceEnabled.load()) {
+            StopTrace();
+            WriteTraceJson("trace.json");
+        } else {
+            StartTrace();
+        }
+    }
+}
+
+// Cursor capture for the shown mode; returns true if Exit was picked in the menu
+static bool HandleMenuAndCursor(GameMode mode, int menuSelection) {
+    if (mode == MAIN_MENU && menuSelection == 1 &&
+        (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE))) {
+        return true;
+    }
+    
+    // Disable cursor only during gameplay
+    if (mode == PLAYING) {
+        if (!IsCursorHidden()) DisableCursor();
+    } else {
+        if (IsCursorHidden()) EnableCursor();
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    // --record <file> logs seed and per-tick input; --replay <file> plays it back;
+    // --profile <file> profiles from the start and writes the frame CSV on exit;
+    // --perf-counters adds hardware counters (Linux) to the profile;
+    // --trace <file> records a timeline of every thread and writes it on exit;
+    // --fps <n|refresh> caps the frame rate (0 = uncapped, default 60);
+    // --resolution <width>x<height> sets the starting window size (the
+    // window stays resizable);
+    // --low-latency re-samples mouse look right before rendering and, unless
+    // --fps is given, runs at the monitor's refresh rate;
+    // --threaded runs the simulation on its own thread, pipelined with rendering
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    const char* profilePath = NULL;
+    const char* tracePath = NULL;
+    const char* fpsArg = NULL;
+    const char* resolutionArg = NULL;
+    bool lowLatency = false;
+    bool threaded = false;
+    bool perfCounters = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--low-latency") == 0) lowLatency = true;
+        else if (strcmp(argv[i], "--threaded") == 0) threaded = true;
+        else if (strcmp(argv[i], "--perf-counters") == 0) perfCounters = true;
+        else if (i + 1 >= argc) break;
+        else if (strcmp(argv[i], "--record") == 0) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0) replayPath = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0) profilePath = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0) tracePath = argv[++i];
+        else if (strcmp(argv[i], "--fps") == 0) fpsArg = argv[++i];
+        else if (strcmp(argv[i], "--resolution") == 0) resolutionArg = argv[++i];
+    }
+    SetProfilerEnabled(profilePath != NULL);
+    if (perfCounters) SetProfilerCounters(true);
+    SetTraceThreadName("main");
+    if (tracePath) StartTrace();
+    
+    Replay replay = {};
+    unsigned int seed = (unsigned int)time(NULL);
+    if (replayPath) {
+        if (!StartReplayPlayback(&replay, replayPath)) return 1;
+        seed = replay.seed;
+    } else if (recordPath) {
+        if (!StartReplayRecording(&replay, recordPath, seed)) return 1;
+    }
+    
+    // Audio thread: device init and decoding overlap window creation,
+    // then it keeps streaming music for the rest of the run
+    StartAudio();
+    
+    int windowWidth = DEFAULT_SCREEN_WIDTH;
+    int windowHeight = DEFAULT_SCREEN_HEIGHT;
+    if (resolutionArg && sscanf(resolutionArg, "%dx%d", &windowWidth, &windowHeight) != 2) {
+        windowWidth = DEFAULT_SCREEN_WIDTH;
+        windowHeight = DEFAULT_SCREEN_HEIGHT;
+    }
+    if (windowWidth < MIN_SCREEN_WIDTH) windowWidth = MIN_SCREEN_WIDTH;
+    if (windowHeight < MIN_SCREEN_HEIGHT) windowHeight = MIN_SCREEN_HEIGHT;
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+    InitWindow(windowWidth, windowHeight, "MazeKiller3D - LD58");
+    SetWindowMinSize(MIN_SCREEN_WIDTH, MIN_SCREEN_HEIGHT);
+    
+    // Our pacer sleeps to the frame deadline instead of raylib's limiter, so
+    // EndDrawing returns right after the buffer swap
+    int fps = 60;
+    if ((fpsArg && strcmp(fpsArg, "refresh") == 0) || (!fpsArg && lowLatency)) {
+        fps = GetMonitorRefreshRate(GetCurrentMonitor());
+    } else if (fpsArg) {
+        fps = atoi(fpsArg);
+    }
+    FramePacer pacer;
+    SetFramePacerRate(&pacer, fps);
+    TraceLog(LOG_INFO, "Frame rate: %s%s%s", fps > 0 ? TextFormat("%d FPS", fps) : "uncapped",
+             lowLatency ? ", low-latency look" : "", threaded ? ", threaded simulation" : "");
+    double windowSeconds = GetStartupSeconds();
     
     GameState game = {0};
+    SeedRng(&game.rng, seed);
     InitGame(&game);
+    LoadSpriteAtlas(&game.sprites);
+    double initSeconds = GetStartupSeconds();
+    double firstFrameSeconds = 0.0;
+    bool timelineLogged = false;
+    
+    GameInput input = {0};
+    float accumulator = 0.0f;
+    RenderState* view = new RenderState(); // What the single-threaded loop draws
+    SimThread* sim = NULL;
+    if (threaded) {
+        sim = new SimThread();
+        StartSimThread(sim, &game, &replay);
+    }
     
     while (!WindowShouldClose()) {
-        float deltaTime = GetFrameTime();
-        
-        // Check if exit was selected from menu
-        if (game.mode == MAIN_MENU && game.menuSelection == 1 && 
-            (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_SPACE))) {
-            break;
-        }
+        WaitNextFrame(&pacer);
+        float frameTime = GetFrameTime();
+        if (frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+        BeginProfileFrame();
+        HandleProfilerKeys();
         
-        // Disable cursor only during gameplay
-        if (game.mode == PLAYING) {
-            if (!IsCursorHidden()) DisableCursor();
+        if (threaded) {
+            // The sim thread ticks on its own; draw its newest state,
+            // interpolated by how long ago that tick ran
+            if (sim->finished.load()) break;
+            const RenderState* shown = AcquireRenderState(sim);
+            if (HandleMenuAndCursor(shown->mode, shown->menuSelection)) break;
+            float lateYaw = 0.0f;
+            if (replay.mode != REPLAY_PLAYBACK) {
+                float unapplied = SubmitSimInput(sim, shown);
+                if (lowLatency && shown->mode == PLAYING) lateYaw = unapplied * shown->player.mouseSensitivity;
+            }
+            float alpha = (float)((SimClock() - shown->tickTime) / SIM_DT);
+            if (alpha > 1.0f) alpha = 1.0f;
+            DrawGame(shown, alpha, lateYaw);
+            SetProfileSimToPresent(SimClock() - shown->tickTime);
         } else {
-            if (IsCursorHidden()) EnableCursor();
+            if (HandleMenuAndCursor(game.mode, game.menuSelection)) break;
+            
+            // Fixed-step simulation, rendering interpolates between the last two ticks.
+            // In playback each tick's input comes from the recording instead.
+            if (replay.mode != REPLAY_PLAYBACK) {
+                PollGameInput(&input);
+            }
+            accumulator += frameTime;
+            int steps = 0;
+            while (accumulator >= SIM_DT && steps < MAX_SIM_STEPS_PER_FRAME) {
+                if (replay.mode == REPLAY_PLAYBACK) {
+                    if (!ReadReplayTick(&replay, &input)) break;
+                } else {
+                    input.levelReady = IsLevelLoadReady(&game.loader, game.currentLevel);
+                }
+                UpdateGame(&game, &input, SIM_DT);
+                EndReplayTick(&replay, &input, HashGameState(&game));
+                ConsumeGameInput(&input);
+                accumulator -= SIM_DT;
+                steps++;
+            }
+            if (replay.finished) break;
+            // Too far behind: drop the backlog rather than spiral
+            if (accumulator >= SIM_DT) accumulator = 0.0f;
+            double simEnd = GetTime();
+            
+            // Low-latency look: poll again just before the raycast and show the
+            // mouse movement since the last tick as a late yaw. The delta stays
+            // in input, so the next tick still applies it (and replays record it);
+            // edges seen by this poll are latched into input the same way.
+            float lateYaw = 0.0f;
+            if (lowLatency && replay.mode != REPLAY_PLAYBACK && game.mode == PLAYING) {
+                PollInputEvents();
+                PollGameInput(&input);
+                HandleProfilerKeys();
+                lateYaw = input.lookDelta * game.player.mouseSensitivity;
+            }
+            
+            CaptureRenderState(&game, view);
+            DrawGame(view, accumulator / SIM_DT, lateYaw);
+            SetProfileSimToPresent(GetTime() - simEnd);
         }
         
-        UpdateGame(&game, deltaTime);
-        DrawGame(&game);
+        // Startup timeline, once both the first frame and audio are in
+        if (firstFrameSeconds == 0.0) {
+            firstFrameSeconds = GetStartupSeconds();
+        }
+        if (IsAudioReady() && !timelineLogged) {
+            double deviceSeconds, assetsSeconds;
+            GetAudioStartupTimes(&deviceSeconds, &assetsSeconds);
+            TraceLog(LOG_INFO, "Startup: window %.1f ms, game init %.1f ms, first frame %.1f ms, "
+                     "audio device %.1f ms, audio assets %.1f ms",
+                     windowSeconds * 1000.0, initSeconds * 1000.0, firstFrameSeconds * 1000.0,
+                     deviceSeconds * 1000.0, assetsSeconds * 1000.0);
+            timelineLogged = true;
+        }
     }
     
-    if (IsSoundReady(game.collectSound)) UnloadSound(game.collectSound);
-    if (IsSoundReady(game.stabSound)) UnloadSound(game.stabSound);
-    if (IsSoundReady(game.purchaseSound)) UnloadSound(game.purchaseSound);
-    if (IsMusicReady(game.horrorMusic)) {
-        if (IsMusicStreamPlaying(game.horrorMusic)) {
-            StopMusicStream(game.horrorMusic);
-        }
-        UnloadMusicStream(game.horrorMusic);
+    if (sim) {
+        StopSimThread(sim);
+        delete sim;
+    }
+    delete view;
+    
+    // Unloads sounds, closes the device and the asset pack on the audio thread
+    StopAudio();
+    CloseReplay(&replay);
+    if (profilePath) {
+        WriteProfileCsv(profilePath);
+    }
+    if (tracePath) {
+        StopTrace();
+        WriteTraceJson(tracePath);
     }
-    CloseAudioDevice();
+    CancelLevelLoad(&game.loader);
+    UnloadSpriteAtlas(&game.sprites);
     CloseWindow();
     return 0;
 }
@@ -1,7 +1,128 @@
 #include "map.h"
+#include "rng.h"
+#include <cmath>
+#include <stdlib.h>
+#include <vector>
 
-// Global map pointers
-const int* currentMap = (const int*)worldMap1;
-int currentMapWidth = MAP_WIDTH;
-int currentMapHeight = MAP_HEIGHT;
+// Map pointers (per thread)
+thread_local const int* currentMap = (const int*)worldMap1;
+thread_local int currentMapWidth = MAP_WIDTH;
+thread_local int currentMapHeight = MAP_HEIGHT;
 
+void SetCurrentMap(const int* map, int width, int height) {
+    currentMap = map;
+    currentMapWidth = width;
+    currentMapHeight = height;
+}
+
+bool HasLineOfSight(Vector2 from, Vector2 to) {
+    int x = (int)floorf(from.x);
+    int y = (int)floorf(from.y);
+    int endX = (int)floorf(to.x);
+    int endY = (int)floorf(to.y);
+    MapView map = GetCurrentMapView();
+    
+    if (GetMapTile(map, x, y) > 0) return false;
+    
+    float dx = to.x - from.x;
+    float dy = to.y - from.y;
+    int stepX = (dx > 0) ? 1 : (dx < 0) ? -1 : 0;
+    int stepY = (dy > 0) ? 1 : (dy < 0) ? -1 : 0;
+    
+    // Parametric distance (t in [0, 1]) to the next vertical / horizontal grid line
+    float tDeltaX = (stepX != 0) ? fabsf(1.0f / dx) : 1e30f;
+    float tDeltaY = (stepY != 0) ? fabsf(1.0f / dy) : 1e30f;
+    float tMaxX = (stepX > 0) ? (x + 1.0f - from.x) * tDeltaX
+                : (stepX < 0) ? (from.x - x) * tDeltaX : 1e30f;
+    float tMaxY = (stepY > 0) ? (y + 1.0f - from.y) * tDeltaY
+                : (stepY < 0) ? (from.y - y) * tDeltaY : 1e30f;
+    
+    int steps = abs(endX - x) + abs(endY - y);
+    while (steps > 0 && (x != endX || y != endY)) {
+        if (tMaxX < tMaxY) {
+            x += stepX;
+            tMaxX += tDeltaX;
+            steps--;
+        } else if (tMaxY < tMaxX) {
+            y += stepY;
+            tMaxY += tDeltaY;
+            steps--;
+        } else {
+            // Segment passes exactly through a corner: blocked only when walls
+            // sit on both sides of it, so grazing a single wall's corner sees past
+            if (GetMapTile(map, x + stepX, y) > 0 && GetMapTile(map, x, y + stepY) > 0) return false;
+            x += stepX;
+            y += stepY;
+            tMaxX += tDeltaX;
+            tMaxY += tDeltaY;
+            steps -= 2;
+        }
+        
+        if (GetMapTile(map, x, y) > 0) return false;
+    }
+    
+    return true;
+}
+
+void HasLineOfSightBatch(const Vector2* from, const Vector2* to, int count, bool* visible) {
+    for (int i = 0; i < count; i++) {
+        visible[i] = HasLineOfSight(from[i], to[i]);
+    }
+}
+
+void GenerateMaze(int* map, int width, int height, unsigned int seed) {
+    Rng rng;
+    SeedRng(&rng, seed);
+    for (int i = 0; i < width * height; i++) {
+        map[i] = 1;
+    }
+    
+    // Depth-first backtracker over the odd cells, with an explicit stack
+    const int dirX[4] = { 2, -2, 0, 0 };
+    const int dirY[4] = { 0, 0, 2, -2 };
+    std::vector<int> stack;
+    map[1 * width + 1] = 0;
+    stack.push_back(1 * width + 1);
+    while (!stack.empty()) {
+        int cell = stack.back();
+        int x = cell % width;
+        int y = cell / width;
+        
+        int options[4];
+        int optionCount = 0;
+        for (int d = 0; d < 4; d++) {
+            int nx = x + dirX[d];
+            int ny = y + dirY[d];
+            if (nx > 0 && nx < width - 1 && ny > 0 && ny < height - 1 && map[ny * width + nx] == 1) {
+                options[optionCount++] = d;
+            }
+        }
+        if (optionCount == 0) {
+            stack.pop_back();
+            continue;
+        }
+        
+        int d = options[RngRange(&rng, optionCount)];
+        int nx = x + dirX[d];
+        int ny = y + dirY[d];
+        map[(y + dirY[d] / 2) * width + x + dirX[d] / 2] = 0;
+        map[ny * width + nx] = 0;
+        stack.push_back(ny * width + nx);
+    }
+    
+    // Knock out about one in ten inner walls between two corridors
+    for (int y = 1; y < height - 1; y++) {
+        for (int x = 1; x < width - 1; x++) {
+            bool betweenX = (x % 2 == 0) && (y % 2 == 1) && x + 1 < width - 1;
+            bool betweenY = (y % 2 == 0) && (x % 2 == 1) && y + 1 < height - 1;
+            if ((betweenX || betweenY) && map[y * width + x] == 1 && RngRange(&rng, 10) == 0) {
+                map[y * width + x] = 0;
+            }
+        }
+    }
+    
+    // Door on the east wall, next to a corridor
+    int doorY = (height / 2) | 1;
+    if (doorY >= height - 1) doorY = 1;
+    map[doorY * width + width - 1] = 2;
+}
@@ -1,6 +1,8 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include <raylib.h>
+
 const int MAP_WIDTH = 16;
 const int MAP_HEIGHT = 16;
 
@@ -119,15 +121,49 @@ const int worldMap5[20][20] = {
     {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
 };
 
-// Current active map pointer
-extern const int* currentMap;
-extern int currentMapWidth;
-extern int currentMapHeight;
+// Current active map pointer. Per thread, so a level can be generated off the
+// main thread while the main thread keeps reading its own map.
+extern thread_local const int* currentMap;
+extern thread_local int currentMapWidth;
+extern thread_local int currentMapHeight;
+
+// Make map the calling thread's current map
+void SetCurrentMap(const int* map, int width, int height);
+
+// A map and its size. Tile loops take one with GetCurrentMapView at entry,
+// so the per-tile reads don't go through thread-local storage.
+struct MapView {
+    const int* tiles;
+    int width;
+    int height;
+};
+
+inline MapView GetCurrentMapView() {
+    MapView view = { currentMap, currentMapWidth, currentMapHeight };
+    return view;
+}
+
+// Helper to get map tile; out of bounds reads as wall
+inline int GetMapTile(const MapView& map, int x, int y) {
+    if (x < 0 || x >= map.width || y < 0 || y >= map.height) return 1;
+    return map.tiles[y * map.width + x];
+}
 
-// Helper to get map tile
 inline int GetMapTile(int x, int y) {
-    if (x < 0 || x >= currentMapWidth || y < 0 || y >= currentMapHeight) return 1;
-    return currentMap[y * currentMapWidth + x];
+    return GetMapTile(GetCurrentMapView(), x, y);
 }
 
+// Exact line of sight between two points (supercover DDA over map tiles).
+// Any non-empty tile blocks, including both tiles at a diagonal corner.
+bool HasLineOfSight(Vector2 from, Vector2 to);
+
+// Answer count (from[i], to[i]) visibility queries at once
+void HasLineOfSightBatch(const Vector2* from, const Vector2* to, int count, bool* visible);
+
+// Fill map (width * height) with a random maze: walls on even rows/columns,
+// corridors carved between odd cells, a few extra openings so there are
+// loops, and a door on the east wall. Odd sizes fill the map exactly. Used
+// for synthetic large levels.
+void GenerateMaze(int* map, int width, int height, unsigned int seed);
+
 #endif
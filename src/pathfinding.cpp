@@ -0,0 +1,366 @@
+#include "pathfinding.h"
+#include "map.h"
+#include "trace.h"
+#include <cmath>
+#include <algorithm>
+#include <queue>
+#include <functional>
+
+// A* pathfinding node
+struct AStarNode {
+    int x, y;
+    float g, h, f;
+    int parentX, parentY;
+
+    bool operator>(const AStarNode& other) const {
+        return f > other.f;
+    }
+};
+
+// Calculate heuristic (Manhattan distance)
+float Heuristic(int x1, int y1, int x2, int y2) {
+    return fabsf((float)(x1 - x2)) + fabsf((float)(y1 - y2));
+}
+
+// A* pathfinding algorithm
+std::vector<Vector2> FindPathAStar(Vector2 start, Vector2 goal, int* nodesExpanded) {
+    TRACE_SCOPE("FindPathAStar");
+    std::vector<Vector2> path;
+    if (nodesExpanded) *nodesExpanded = 0;
+
+    int startX = (int)start.x;
+    int startY = (int)start.y;
+    int goalX = (int)goal.x;
+    int goalY = (int)goal.y;
+    MapView map = GetCurrentMapView();
+
+    // Check if start or goal is invalid
+    if (GetMapTile(map, startX, startY) != 0 || GetMapTile(map, goalX, goalY) != 0) {
+        return path;
+    }
+
+    // Search state lives in this thread's scratch arena, gone in one rewind
+    ArenaScope scratch(GetScratchArena());
+    int width = map.width;
+    size_t cellCount = (size_t)width * map.height;
+
+    // Priority queue for open set
+    std::priority_queue<AStarNode, ArenaVector<AStarNode>, std::greater<AStarNode>> openSet(
+        std::greater<AStarNode>(), MakeArenaVector<AStarNode>(scratch.arena));
+
+    // Closed set
+    ArenaVector<unsigned char> closedSet(cellCount, 0, ArenaAllocator<unsigned char>(scratch.arena));
+    ArenaVector<AStarNode> nodeMap(cellCount, AStarNode(), ArenaAllocator<AStarNode>(scratch.arena));
+
+    // Initialize start node
+    AStarNode startNode;
+    startNode.x = startX;
+    startNode.y = startY;
+    startNode.g = 0;
+    startNode.h = Heuristic(startX, startY, goalX, goalY);
+    startNode.f = startNode.g + startNode.h;
+    startNode.parentX = -1;
+    startNode.parentY = -1;
+
+    openSet.push(startNode);
+    nodeMap[startY * width + startX] = startNode;
+
+    // Directions: 4-way movement
+    int dx[] = {0, 1, 0, -1};
+    int dy[] = {-1, 0, 1, 0};
+
+    while (!openSet.empty()) {
+        AStarNode current = openSet.top();
+        openSet.pop();
+
+        // Skip if already processed
+        if (closedSet[current.y * width + current.x]) continue;
+
+        closedSet[current.y * width + current.x] = true;
+        if (nodesExpanded) (*nodesExpanded)++;
+
+        // Goal reached
+        if (current.x == goalX && current.y == goalY) {
+            // Reconstruct path
+            int x = goalX, y = goalY;
+            while (!(x == startX && y == startY)) {
+                path.push_back({(float)x + 0.5f, (float)y + 0.5f});
+                AStarNode& node = nodeMap[y * width + x];
+                int tmpX = node.parentX;
+                int tmpY = node.parentY;
+                x = tmpX;
+                y = tmpY;
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        // Explore neighbors
+        for (int i = 0; i < 4; i++) {
+            int nx = current.x + dx[i];
+            int ny = current.y + dy[i];
+
+            // Check bounds and walkability
+            if (nx < 0 || nx >= map.width || ny < 0 || ny >= map.height) continue;
+            if (map.tiles[ny * width + nx] != 0) continue;
+            if (closedSet[ny * width + nx]) continue;
+
+            float newG = current.g + 1.0f;
+            float h = Heuristic(nx, ny, goalX, goalY);
+            float newF = newG + h;
+
+            // Add to open set if not visited or found better path
+            if (nodeMap[ny * width + nx].f == 0 || newG < nodeMap[ny * width + nx].g) {
+                AStarNode neighbor;
+                neighbor.x = nx;
+                neighbor.y = ny;
+                neighbor.g = newG;
+                neighbor.h = h;
+                neighbor.f = newF;
+                neighbor.parentX = current.x;
+                neighbor.parentY = current.y;
+
+                nodeMap[ny * width + nx] = neighbor;
+                openSet.push(neighbor);
+            }
+        }
+    }
+
+    // No path found
+    return path;
+}
+
+// ---------------------------------------------------------------------------
+// D* Lite
+//
+// Terminology follows Koenig & Likhachev: the search runs from the tree root
+// (anchor, the pursuer's cell at build time) and g/rhs are distances to the
+// anchor. The target plays the role of D* Lite's "start", so when the player
+// moves we only bump km and keep expanding until the new cell is consistent.
+// ---------------------------------------------------------------------------
+
+static const float PLANNER_INF = 1e30f;
+static const int PLANNER_DX[] = {0, 1, 0, -1};
+static const int PLANNER_DY[] = {-1, 0, 1, 0};
+
+static bool KeyLess(PlannerKey a, PlannerKey b) {
+    return a.k1 < b.k1 || (a.k1 == b.k1 && a.k2 < b.k2);
+}
+
+// Heap comparator (min-heap on key)
+static bool EntryGreater(const PlannerEntry& a, const PlannerEntry& b) {
+    return KeyLess(b.key, a.key);
+}
+
+static bool IsCellWalkable(const PathPlanner* planner, int cell) {
+    return planner->tiles[cell] == 0; // Callers only pass cells inside the map
+}
+
+static float CellHeuristic(const PathPlanner* planner, int a, int b) {
+    return Heuristic(a % planner->width, a / planner->width, b % planner->width, b / planner->width);
+}
+
+static PlannerKey CalculateKey(const PathPlanner* planner, int cell) {
+    float m = std::min(planner->g[cell], planner->rhs[cell]);
+    return { m + CellHeuristic(planner, planner->targetCell, cell) + planner->km, m };
+}
+
+static void PushCell(PathPlanner* planner, int cell) {
+    planner->open.push_back({ CalculateKey(planner, cell), cell });
+    std::push_heap(planner->open.begin(), planner->open.end(), EntryGreater);
+}
+
+static void UpdateVertex(PathPlanner* planner, int cell) {
+    if (cell != planner->anchorCell) {
+        float best = PLANNER_INF;
+        if (IsCellWalkable(planner, cell)) {
+            int x = cell % planner->width;
+            int y = cell / planner->width;
+            for (int i = 0; i < 4; i++) {
+                int nx = x + PLANNER_DX[i];
+                int ny = y + PLANNER_DY[i];
+                if (nx < 0 || nx >= planner->width || ny < 0 || ny >= planner->height) continue;
+                int next = ny * planner->width + nx;
+                if (!IsCellWalkable(planner, next)) continue;
+                best = std::min(best, planner->g[next] + 1.0f);
+            }
+        }
+        planner->rhs[cell] = best;
+    }
+    if (planner->g[cell] != planner->rhs[cell]) {
+        PushCell(planner, cell);
+    }
+}
+
+static void UpdateNeighbors(PathPlanner* planner, int cell) {
+    int x = cell % planner->width;
+    int y = cell / planner->width;
+    for (int i = 0; i < 4; i++) {
+        int nx = x + PLANNER_DX[i];
+        int ny = y + PLANNER_DY[i];
+        if (nx < 0 || nx >= planner->width || ny < 0 || ny >= planner->height) continue;
+        UpdateVertex(planner, ny * planner->width + nx);
+    }
+}
+
+static void ComputeShortestPath(PathPlanner* planner) {
+    int target = planner->targetCell;
+
+    while (!planner->open.empty()) {
+        const PlannerEntry top = planner->open.front();
+        bool targetInconsistent = planner->rhs[target] != planner->g[target];
+        if (!KeyLess(top.key, CalculateKey(planner, target)) && !targetInconsistent) break;
+
+        std::pop_heap(planner->open.begin(), planner->open.end(), EntryGreater);
+        planner->open.pop_back();
+
+        int u = top.cell;
+        // Stale heap entry for a cell that has since become consistent
+        if (planner->g[u] == planner->rhs[u]) continue;
+
+        PlannerKey current = CalculateKey(planner, u);
+        if (KeyLess(top.key, current)) {
+            planner->open.push_back({ current, u });
+            std::push_heap(planner->open.begin(), planner->open.end(), EntryGreater);
+            continue;
+        }
+
+        planner->nodesTouched++;
+        if (planner->g[u] > planner->rhs[u]) {
+            planner->g[u] = planner->rhs[u];
+            UpdateNeighbors(planner, u);
+        } else {
+            planner->g[u] = PLANNER_INF;
+            UpdateVertex(planner, u);
+            UpdateNeighbors(planner, u);
+        }
+    }
+}
+
+static void RebuildPlanner(PathPlanner* planner, int anchor, int target) {
+    planner->width = currentMapWidth;
+    planner->height = currentMapHeight;
+    size_t cellCount = (size_t)planner->width * planner->height;
+    planner->g.assign(cellCount, PLANNER_INF);
+    planner->rhs.assign(cellCount, PLANNER_INF);
+    planner->open.clear();
+    planner->anchorCell = anchor;
+    planner->targetCell = target;
+    planner->km = 0.0f;
+    planner->valid = true;
+    planner->rebuildCount++;
+
+    planner->rhs[anchor] = 0.0f;
+    PushCell(planner, anchor);
+    ComputeShortestPath(planner);
+}
+
+// Walk down the g gradient from the target to the anchor.
+// Returns false if the target is unreachable from the anchor.
+static bool TraceToAnchor(const PathPlanner* planner, ArenaVector<int>& cells) {
+    cells.clear();
+    int cell = planner->targetCell;
+    if (planner->g[cell] >= PLANNER_INF) return false;
+
+    int maxSteps = planner->width * planner->height;
+    cells.push_back(cell);
+    while (cell != planner->anchorCell && (int)cells.size() <= maxSteps) {
+        int x = cell % planner->width;
+        int y = cell / planner->width;
+        int bestCell = -1;
+        float bestG = planner->g[cell];
+        for (int i = 0; i < 4; i++) {
+            int nx = x + PLANNER_DX[i];
+            int ny = y + PLANNER_DY[i];
+            if (nx < 0 || nx >= planner->width || ny < 0 || ny >= planner->height) continue;
+            int next = ny * planner->width + nx;
+            if (!IsCellWalkable(planner, next)) continue;
+            if (planner->g[next] < bestG) {
+                bestG = planner->g[next];
+                bestCell = next;
+            }
+        }
+        if (bestCell < 0) return false;
+        cell = bestCell;
+        cells.push_back(cell);
+    }
+    return cell == planner->anchorCell;
+}
+
+void ResetPathPlanner(PathPlanner* planner) {
+    planner->valid = false;
+    planner->open.clear();
+    planner->nodesTouched = 0;
+}
+
+void SetPathPlannerArena(PathPlanner* planner, Arena* arena) {
+    planner->g = MakeArenaVector<float>(arena);
+    planner->rhs = MakeArenaVector<float>(arena);
+    planner->open = MakeArenaVector<PlannerEntry>(arena);
+    planner->traceCells = MakeArenaVector<int>(arena);
+    ResetPathPlanner(planner);
+}
+
+bool PlanPath(PathPlanner* planner, Vector2 start, Vector2 goal, ArenaVector<Vector2>& path) {
+    TRACE_SCOPE("PlanPath");
+    path.clear();
+    planner->nodesTouched = 0;
+
+    int startX = (int)start.x;
+    int startY = (int)start.y;
+    int goalX = (int)goal.x;
+    int goalY = (int)goal.y;
+    MapView map = GetCurrentMapView();
+
+    if (GetMapTile(map, startX, startY) != 0 || GetMapTile(map, goalX, goalY) != 0) {
+        return false;
+    }
+
+    int startCell = startY * map.width + startX;
+    int goalCell = goalY * map.width + goalX;
+
+    planner->tiles = map.tiles;
+    if (!planner->valid || planner->width != map.width || planner->height != map.height) {
+        RebuildPlanner(planner, startCell, goalCell);
+    } else {
+        if (goalCell != planner->targetCell) {
+            planner->km += CellHeuristic(planner, planner->targetCell, goalCell);
+            planner->targetCell = goalCell;
+        }
+        ComputeShortestPath(planner);
+    }
+
+    // The pursuer follows the tree from its anchor, so it normally sits on the
+    // traced path. If it left the tree (or the target is cut off), re-root.
+    ArenaVector<int>& cells = planner->traceCells;
+    bool traced = TraceToAnchor(planner, cells);
+    ArenaVector<int>::iterator it = std::find(cells.begin(), cells.end(), startCell);
+    if (!traced || it == cells.end()) {
+        if (planner->anchorCell == startCell && !traced) return false;
+        RebuildPlanner(planner, startCell, goalCell);
+        if (!TraceToAnchor(planner, cells)) return false;
+        it = std::find(cells.begin(), cells.end(), startCell);
+    }
+
+    // cells runs target -> anchor; emit start -> target without the start cell
+    for (ArenaVector<int>::iterator c = it; c != cells.begin(); ) {
+        --c;
+        path.push_back({(float)(*c % planner->width) + 0.5f, (float)(*c / planner->width) + 0.5f});
+    }
+    return true;
+}
+
+void NotifyTileChanged(PathPlanner* planner, int x, int y) {
+    if (!planner->valid) return;
+    if (x < 0 || x >= planner->width || y < 0 || y >= planner->height) return;
+
+    int cell = y * planner->width + x;
+    planner->tiles = currentMap;
+    if (cell == planner->anchorCell && !IsCellWalkable(planner, cell)) {
+        planner->valid = false;
+        return;
+    }
+
+    UpdateVertex(planner, cell);
+    UpdateNeighbors(planner, cell);
+}
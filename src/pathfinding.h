@@ -0,0 +1,56 @@
+#ifndef PATHFINDING_H
+#define PATHFINDING_H
+
+#include <raylib.h>
+#include <vector>
+#include "arena.h"
+
+// D* Lite priority key
+struct PlannerKey {
+    float k1;
+    float k2;
+};
+
+struct PlannerEntry {
+    PlannerKey key;
+    int cell;
+};
+
+// Incremental D* Lite planner (one per pursuer).
+// The search tree is rooted at an anchor cell (the pursuer's cell when the
+// tree was built) and grows towards the target. A moving target is handled
+// like D* Lite's moving start (key modifier), so a one-step move of the player
+// only expands the few cells the new target still needs.
+struct PathPlanner {
+    const int* tiles; // Map being planned on, taken from the current map on each call
+    int width;
+    int height;
+    ArenaVector<float> g;
+    ArenaVector<float> rhs;
+    ArenaVector<PlannerEntry> open; // Binary heap, stale entries skipped lazily
+    int anchorCell;
+    int targetCell;
+    float km;
+    bool valid;
+    ArenaVector<int> traceCells; // Scratch for path extraction
+    int nodesTouched;   // Cells expanded by the last replan
+    int rebuildCount;   // Replans that had to start from scratch
+};
+
+// A* pathfinding from start to goal (fresh search every call)
+std::vector<Vector2> FindPathAStar(Vector2 start, Vector2 goal, int* nodesExpanded = nullptr);
+
+// Drop the planner's search tree (call when the map changes)
+void ResetPathPlanner(PathPlanner* planner);
+
+// Drop the search tree and have the planner allocate from arena (null = the heap)
+void SetPathPlannerArena(PathPlanner* planner, Arena* arena);
+
+// Repair the search tree for the current positions and write the path from
+// start to goal (cell centers, start cell excluded). Returns false if no path.
+bool PlanPath(PathPlanner* planner, Vector2 start, Vector2 goal, ArenaVector<Vector2>& path);
+
+// Repair the search tree after the tile at (x, y) changed walkability
+void NotifyTileChanged(PathPlanner* planner, int x, int y);
+
+#endif
@@ -0,0 +1,122 @@
+#include "perfcounters.h"
+#include <raylib.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+struct PerfCounterConfig {
+    const char* name;
+    unsigned int type;
+    unsigned long long config;
+};
+
+static const PerfCounterConfig counterConfigs[PERF_COUNTER_COUNT] = {
+    { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "L1D misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { "LLC misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "branch misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+// The calling thread's group. Cycles lead it, so one read returns every
+// member, all counted over the same interval.
+struct PerfGroup {
+    int fds[PERF_COUNTER_COUNT];     // -1 for missing counters
+    int members[PERF_COUNTER_COUNT]; // Position in the group read, -1 if missing
+    int memberCount;
+    bool open;
+};
+
+static thread_local PerfGroup group;
+
+static int OpenCounter(const PerfCounterConfig& counter, int leader) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter.type;
+    attr.config = counter.config;
+    attr.disabled = leader == -1; // Members follow the leader, which is enabled last
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC);
+}
+
+bool OpenPerfCounters() {
+    if (group.open) return true;
+    int leader = OpenCounter(counterConfigs[PERF_CYCLES], -1);
+    if (leader < 0) {
+        TraceLog(LOG_WARNING, "PERF: counters unavailable (%s)", strerror(errno));
+        return false;
+    }
+    
+    group.fds[PERF_CYCLES] = leader;
+    group.members[PERF_CYCLES] = 0;
+    group.memberCount = 1;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (i == PERF_CYCLES) continue;
+        group.fds[i] = OpenCounter(counterConfigs[i], leader);
+        group.members[i] = group.fds[i] < 0 ? -1 : group.memberCount++;
+        if (group.fds[i] < 0) TraceLog(LOG_WARNING, "PERF: no %s counter (%s)", counterConfigs[i].name, strerror(errno));
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    group.open = true;
+    TraceLog(LOG_INFO, "PERF: counting %d of %d hardware counters", group.memberCount, PERF_COUNTER_COUNT);
+    return true;
+}
+
+void ClosePerfCounters() {
+    if (!group.open) return;
+    // Members first, the leader last
+    for (int i = PERF_COUNTER_COUNT - 1; i >= 0; i--) {
+        if (group.fds[i] >= 0) close(group.fds[i]);
+    }
+    group.open = false;
+}
+
+bool IsPerfCounterAvailable(PerfCounter counter) {
+    return group.open && group.members[counter] >= 0;
+}
+
+bool ReadPerfCounters(PerfSample* sample) {
+    if (!group.open) return false;
+    // PERF_FORMAT_GROUP layout: count, time enabled, time running, then one value per member
+    unsigned long long data[3 + PERF_COUNTER_COUNT];
+    ssize_t size = (ssize_t)((3 + group.memberCount) * sizeof(unsigned long long));
+    if (read(group.fds[PERF_CYCLES], data, size) != size) return false;
+    if (data[2] == 0) return false; // Never scheduled yet
+    
+    sample->timeEnabled = data[1];
+    sample->timeRunning = data[2];
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        int member = group.members[i];
+        sample->values[i] = member < 0 ? 0 : data[3 + member];
+    }
+    return true;
+}
+#else
+bool OpenPerfCounters() {
+    TraceLog(LOG_WARNING, "PERF: counters are only supported on Linux");
+    return false;
+}
+
+void ClosePerfCounters() {
+}
+
+bool IsPerfCounterAvailable(PerfCounter counter) {
+    (void)counter;
+    return false;
+}
+
+bool ReadPerfCounters(PerfSample* sample) {
+    (void)sample;
+    return false;
+}
+#endif
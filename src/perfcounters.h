@@ -0,0 +1,40 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+// Hardware performance counters for the calling thread, via perf_event_open
+// on Linux. Counts user-space work only, so it runs at the default
+// perf_event_paranoid level. Elsewhere, or when the kernel, hardware or a VM
+// doesn't expose the PMU, opening fails and nothing is counted. Counters the
+// CPU lacks are left out individually.
+
+enum PerfCounter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,    // L1 data cache read misses
+    PERF_LLC_MISSES,    // Last-level cache misses
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT
+};
+
+// Counts since the counters were opened (0 for missing counters). If the
+// kernel multiplexes the group, it only counts for part of the time it is
+// enabled; scale a difference of two samples by their enabled / running
+// times, not each total, or a change in the ratio skews it.
+struct PerfSample {
+    unsigned long long values[PERF_COUNTER_COUNT];
+    unsigned long long timeEnabled; // ns the group was enabled
+    unsigned long long timeRunning; // ns it was actually counting
+};
+
+// Open and start the counters as one group on the calling thread. Returns
+// false, logging why, if cycles can't be counted; already open returns true.
+bool OpenPerfCounters();
+
+void ClosePerfCounters();
+
+bool IsPerfCounterAvailable(PerfCounter counter);
+
+// Current raw totals and times. Returns false if the counters aren't open or haven't been scheduled yet.
+bool ReadPerfCounters(PerfSample* sample);
+
+#endif
@@ -0,0 +1,328 @@
+#include "profiler.h"
+#include "alloctrack.h"
+#include <raylib.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+bool profilerEnabled = false;
+thread_local bool profilerThread = false;
+thread_local int profilePhase = PHASE_OTHER;
+bool profilerCounters = false;
+
+struct ProfileFrame {
+    float phaseMs[PHASE_COUNT];
+    float frameMs; // From this frame's start to the next one's
+    float simToPresentMs;
+    AllocCounts allocs[ALLOC_SLOTS]; // Heap allocations per phase (ALLOC_TRACKING builds)
+    PerfSample counters[PHASE_COUNT + 1]; // Hardware counts per phase, whole frame last
+};
+
+struct Profiler {
+    ProfileFrame frames[PROFILE_HISTORY];
+    int current;  // Slot being filled
+    int recorded; // Completed frames before current (at most PROFILE_HISTORY - 1)
+    unsigned long long completedFrames;
+    bool frameStarted;
+    std::chrono::steady_clock::time_point frameStart;
+    
+    // Hardware counters
+    PerfSample frameCounterStart;
+    bool frameCounting;       // frameCounterStart was read when this frame began
+    bool countersRecorded;    // Some frame in the history has counts
+    bool countersUnavailable; // The last attempt to turn them on failed
+    bool counterAvailable[PERF_COUNTER_COUNT];
+};
+
+static Profiler profiler;
+
+static const char* phaseNames[PHASE_COUNT] = {
+    "enemy", "collectibles", "raycast", "sprites", "minimap", "hud", "present"
+};
+
+// Rows past the phases in the overlay and PhaseStats
+const int PROFILE_ROW_FRAME = PHASE_COUNT;
+const int PROFILE_ROW_SIM_TO_PRESENT = PHASE_COUNT + 1;
+
+// CSV names of the ratios derived from each counter (IPC, then misses per
+// thousand instructions); cycles are written as a count
+static const char* counterRatioNames[PERF_COUNTER_COUNT] = {
+    NULL, "ipc", "l1d_mpki", "llc_mpki", "branch_mpki"
+};
+static const char* counterRatioLabels[PERF_COUNTER_COUNT] = {
+    NULL, "ipc", "l1d/ki", "llc/ki", "br/ki"
+};
+
+const int PROFILE_AVERAGE_FRAMES = 120; // Window for the rolling averages
+const float PROFILE_GRAPH_MS = 33.3f;   // Frame time at the top of the graph
+
+void SetProfilerEnabled(bool enabled) {
+    if (enabled && !profilerEnabled) {
+        // Start from an empty history
+        profiler.current = 0;
+        profiler.recorded = 0;
+        profiler.frameStarted = false;
+        profiler.countersRecorded = profilerCounters;
+        memset(&profiler.frames[0], 0, sizeof(ProfileFrame));
+        
+        // Drop what was allocated while disabled
+        AllocCounts stale[ALLOC_SLOTS];
+        TakeThreadAllocCounts(stale);
+    }
+    profilerEnabled = enabled;
+}
+
+bool SetProfilerCounters(bool enabled) {
+    profiler.countersUnavailable = enabled && !OpenPerfCounters();
+    if (profiler.countersUnavailable) enabled = false;
+    if (!enabled) ClosePerfCounters();
+    for (int counter = 0; enabled && counter < PERF_COUNTER_COUNT; counter++) {
+        profiler.counterAvailable[counter] = IsPerfCounterAvailable((PerfCounter)counter);
+    }
+    profilerCounters = enabled;
+    profiler.countersRecorded = profiler.countersRecorded || enabled;
+    profiler.frameCounting = false; // The current frame's total would be partial
+    return !profiler.countersUnavailable;
+}
+
+// Add the counts between start and end to total, scaled up if the group
+// only ran for part of the interval
+static void AddCounterDeltas(PerfSample* total, const PerfSample& start, const PerfSample& end) {
+    if (end.timeRunning <= start.timeRunning) return; // Not scheduled in between
+    unsigned long long enabled = end.timeEnabled - start.timeEnabled;
+    unsigned long long running = end.timeRunning - start.timeRunning;
+    double scale = running < enabled ? (double)enabled / running : 1.0;
+    for (int counter = 0; counter < PERF_COUNTER_COUNT; counter++) {
+        if (end.values[counter] <= start.values[counter]) continue; // Counts never go back
+        total->values[counter] += (unsigned long long)((end.values[counter] - start.values[counter]) * scale);
+    }
+}
+
+void BeginProfileFrame() {
+    profilerThread = true;
+    if (!profilerEnabled) return;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (profiler.frameStarted) {
+        PerfSample frameCounterEnd;
+        if (profiler.frameCounting && ReadPerfCounters(&frameCounterEnd)) {
+            AddCounterDeltas(&profiler.frames[profiler.current].counters[PROFILE_ROW_FRAME], profiler.frameCounterStart,
+                             frameCounterEnd);
+        }
+        TakeThreadAllocCounts(profiler.frames[profiler.current].allocs);
+        profiler.frames[profiler.current].frameMs =
+            (float)(std::chrono::duration<double>(now - profiler.frameStart).count() * 1000.0);
+        profiler.current = (profiler.current + 1) % PROFILE_HISTORY;
+        if (profiler.recorded < PROFILE_HISTORY - 1) profiler.recorded++;
+        profiler.completedFrames++;
+    }
+    memset(&profiler.frames[profiler.current], 0, sizeof(ProfileFrame));
+    profiler.frameStart = now;
+    profiler.frameStarted = true;
+    profiler.frameCounting = profilerCounters && ReadPerfCounters(&profiler.frameCounterStart);
+}
+
+void AddProfileTime(ProfilePhase phase, double seconds) {
+    profiler.frames[profiler.current].phaseMs[phase] += (float)(seconds * 1000.0);
+}
+
+void AddProfileCounters(ProfilePhase phase, const PerfSample& start) {
+    PerfSample end;
+    if (ReadPerfCounters(&end)) AddCounterDeltas(&profiler.frames[profiler.current].counters[phase], start, end);
+}
+
+void SetProfileSimToPresent(double seconds) {
+    profiler.frames[profiler.current].simToPresentMs = (float)(seconds * 1000.0);
+}
+
+// Completed frame, age 0 = most recent
+static const ProfileFrame* RecentFrame(int age) {
+    return &profiler.frames[(profiler.current - 1 - age + PROFILE_HISTORY) % PROFILE_HISTORY];
+}
+
+// Phase time (or a PROFILE_ROW_ value) of a completed frame
+static float FrameValue(const ProfileFrame* frame, int phase) {
+    if (phase == PROFILE_ROW_FRAME) return frame->frameMs;
+    if (phase == PROFILE_ROW_SIM_TO_PRESENT) return frame->simToPresentMs;
+    return frame->phaseMs[phase];
+}
+
+static void PhaseStats(int phase, float* average, float* p99) {
+    static float values[PROFILE_HISTORY];
+    int count = profiler.recorded;
+    if (count == 0) {
+        *average = 0.0f;
+        *p99 = 0.0f;
+        return;
+    }
+    
+    float sum = 0.0f;
+    int averageCount = std::min(count, PROFILE_AVERAGE_FRAMES);
+    for (int i = 0; i < count; i++) {
+        values[i] = FrameValue(RecentFrame(i), phase);
+        if (i < averageCount) sum += values[i];
+    }
+    *average = sum / averageCount;
+    
+    int rank = std::min(count - 1, (int)(count * 0.99f));
+    std::nth_element(values, values + rank, values + count);
+    *p99 = values[rank];
+}
+
+// Average heap allocations per frame on an overlay row: its phase's, or all
+// of them on the frame row
+static float AverageAllocs(int row) {
+    int count = std::min(profiler.recorded, PROFILE_AVERAGE_FRAMES);
+    if (count == 0) return 0.0f;
+    unsigned long long sum = 0;
+    for (int i = 0; i < count; i++) {
+        const ProfileFrame* frame = RecentFrame(i);
+        for (int slot = 0; slot < ALLOC_SLOTS; slot++) {
+            if (slot == row || row == PROFILE_ROW_FRAME) sum += frame->allocs[slot].count;
+        }
+    }
+    return (float)sum / count;
+}
+
+// Counts of a phase (or of whole frames on the frame row) summed over the
+// averaging window
+static PerfSample SumCounters(int row) {
+    PerfSample sum = {};
+    int count = std::min(profiler.recorded, PROFILE_AVERAGE_FRAMES);
+    for (int i = 0; i < count; i++) {
+        const PerfSample& counts = RecentFrame(i)->counters[row];
+        for (int counter = 0; counter < PERF_COUNTER_COUNT; counter++) {
+            sum.values[counter] += counts.values[counter];
+        }
+    }
+    return sum;
+}
+
+// Instructions per cycle, or a miss counter's misses per thousand
+// instructions; negative if it wasn't counted
+static double CounterRatio(const PerfSample& counts, int counter) {
+    double cycles = (double)counts.values[PERF_CYCLES];
+    double instructions = (double)counts.values[PERF_INSTRUCTIONS];
+    if (!profiler.counterAvailable[counter] || !profiler.counterAvailable[PERF_INSTRUCTIONS]) return -1.0;
+    if (counter == PERF_INSTRUCTIONS) return cycles > 0.0 ? instructions / cycles : -1.0;
+    return instructions > 0.0 ? counts.values[counter] * 1000.0 / instructions : -1.0;
+}
+
+void DrawProfilerOverlay(int right, int bottom) {
+    const int countersX = allocTrackingBuilt ? 310 : 250; // First counter column
+    const int width = countersX + 20 + (profilerCounters ? 190 : 0);
+    const int lineHeight = 16;
+    const int graphHeight = 60;
+    const int height = 30 + (PROFILE_ROW_SIM_TO_PRESENT + 1) * lineHeight + graphHeight + 10;
+    int x = right - width;
+    int y = bottom - height;
+    
+    DrawRectangle(x, y, width, height, Color{0, 0, 0, 200});
+    DrawText("PROFILER (F3)", x + 10, y + 8, 10, YELLOW);
+    DrawText("avg ms", x + 128, y + 8, 10, YELLOW);
+    DrawText("p99 ms", x + 188, y + 8, 10, YELLOW);
+    if (allocTrackingBuilt) DrawText("allocs", x + 258, y + 8, 10, YELLOW);
+    for (int counter = PERF_INSTRUCTIONS; profilerCounters && counter < PERF_COUNTER_COUNT; counter++) {
+        DrawText(counterRatioLabels[counter], x + countersX + (counter - PERF_INSTRUCTIONS) * 45, y + 8, 10, YELLOW);
+    }
+    
+    for (int phase = 0; phase <= PROFILE_ROW_SIM_TO_PRESENT; phase++) {
+        float average, p99;
+        PhaseStats(phase, &average, &p99);
+        int rowY = y + 26 + phase * lineHeight;
+        Color color = phase == PROFILE_ROW_FRAME ? YELLOW : phase == PROFILE_ROW_SIM_TO_PRESENT ? SKYBLUE : RAYWHITE;
+        const char* name = phase == PROFILE_ROW_FRAME ? "frame" :
+                           phase == PROFILE_ROW_SIM_TO_PRESENT ? "sim -> present" : phaseNames[phase];
+        DrawText(name, x + 10, rowY, 10, color);
+        DrawText(TextFormat("%7.2f", average), x + 120, rowY, 10, color);
+        DrawText(TextFormat("%7.2f", p99), x + 180, rowY, 10, color);
+        if (allocTrackingBuilt && phase != PROFILE_ROW_SIM_TO_PRESENT) {
+            DrawText(TextFormat("%6.1f", AverageAllocs(phase)), x + 250, rowY, 10, color);
+        }
+        if (profilerCounters && phase != PROFILE_ROW_SIM_TO_PRESENT) {
+            PerfSample counts = SumCounters(phase);
+            for (int counter = PERF_INSTRUCTIONS; counter < PERF_COUNTER_COUNT; counter++) {
+                double ratio = CounterRatio(counts, counter);
+                const char* text = ratio < 0.0 ? "  -" : TextFormat(counter == PERF_INSTRUCTIONS ? "%4.2f" : "%4.1f", ratio);
+                DrawText(text, x + countersX + (counter - PERF_INSTRUCTIONS) * 45, rowY, 10, color);
+            }
+        }
+    }
+    
+    // One bar per frame, newest on the right; the line marks 60 FPS
+    int graphX = x + 10;
+    int graphY = y + height - 10 - graphHeight;
+    int graphWidth = width - 20;
+    DrawRectangleLines(graphX, graphY, graphWidth, graphHeight, DARKGRAY);
+    int budgetY = graphY + graphHeight - (int)(16.7f / PROFILE_GRAPH_MS * graphHeight);
+    DrawLine(graphX, budgetY, graphX + graphWidth, budgetY, DARKGREEN);
+    int bars = std::min(profiler.recorded, graphWidth);
+    for (int i = 0; i < bars; i++) {
+        float frameMs = RecentFrame(i)->frameMs;
+        int barHeight = (int)(std::min(frameMs / PROFILE_GRAPH_MS, 1.0f) * graphHeight);
+        Color color = frameMs > 16.7f * 1.5f ? RED : frameMs > 16.7f ? ORANGE : GREEN;
+        int barX = graphX + graphWidth - 1 - i;
+        DrawLine(barX, graphY + graphHeight, barX, graphY + graphHeight - barHeight, color);
+    }
+    if (profiler.countersUnavailable) DrawText("perf counters unavailable", graphX + 4, graphY + 4, 10, GRAY);
+}
+
+bool WriteProfileCsv(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        TraceLog(LOG_ERROR, "Profiler: cannot write %s", path);
+        return false;
+    }
+    
+    fprintf(file, "frame,frame_ms,sim_to_present_ms");
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        fprintf(file, ",%s_ms", phaseNames[phase]);
+    }
+    if (allocTrackingBuilt) {
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            fprintf(file, ",%s_allocs", phaseNames[phase]);
+        }
+        fprintf(file, ",other_allocs,alloc_bytes");
+    }
+    for (int row = 0; profiler.countersRecorded && row <= PROFILE_ROW_FRAME; row++) {
+        const char* name = row == PROFILE_ROW_FRAME ? "frame" : phaseNames[row];
+        fprintf(file, ",%s_cycles", name);
+        for (int counter = PERF_INSTRUCTIONS; counter < PERF_COUNTER_COUNT; counter++) {
+            fprintf(file, ",%s_%s", name, counterRatioNames[counter]);
+        }
+    }
+    fprintf(file, "\n");
+    
+    unsigned long long firstFrame = profiler.completedFrames - profiler.recorded;
+    for (int age = profiler.recorded - 1; age >= 0; age--) {
+        const ProfileFrame* frame = RecentFrame(age);
+        fprintf(file, "%llu,%.4f,%.4f", firstFrame + (profiler.recorded - 1 - age), frame->frameMs,
+                frame->simToPresentMs);
+        for (int phase = 0; phase < PHASE_COUNT; phase++) {
+            fprintf(file, ",%.4f", frame->phaseMs[phase]);
+        }
+        if (allocTrackingBuilt) {
+            unsigned long long bytes = 0;
+            for (int slot = 0; slot < ALLOC_SLOTS; slot++) {
+                fprintf(file, ",%llu", frame->allocs[slot].count);
+                bytes += frame->allocs[slot].bytes;
+            }
+            fprintf(file, ",%llu", bytes);
+        }
+        for (int row = 0; profiler.countersRecorded && row <= PROFILE_ROW_FRAME; row++) {
+            fprintf(file, ",%llu", frame->counters[row].values[PERF_CYCLES]);
+            for (int counter = PERF_INSTRUCTIONS; counter < PERF_COUNTER_COUNT; counter++) {
+                double ratio = CounterRatio(frame->counters[row], counter);
+                if (ratio < 0.0) fprintf(file, ",");
+                else fprintf(file, ",%.3f", ratio);
+            }
+        }
+        fprintf(file, "\n");
+    }
+    
+    bool ok = !ferror(file);
+    fclose(file);
+    if (ok) {
+        TraceLog(LOG_INFO, "Profiler: wrote %d frames to %s", profiler.recorded, path);
+    }
+    return ok;
+}
@@ -0,0 +1,95 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include "perfcounters.h"
+
+// Frame profiler: scoped timers add into the current frame's slot of a ring
+// buffer. While disabled a scope costs one branch and no clock reads.
+// Single-threaded: only the thread that calls BeginProfileFrame records, and
+// scopes on any other thread (e.g. a separate simulation thread) are no-ops.
+// With hardware counters on, each scope also reads the thread's perf
+// counters at entry and exit (two syscalls) and the phase gets the counts.
+
+enum ProfilePhase {
+    PHASE_ENEMY,        // Enemy update (all ticks this frame)
+    PHASE_COLLECTIBLES, // Collectible pickup (all ticks this frame)
+    PHASE_RAYCAST,      // Wall columns
+    PHASE_SPRITES,      // Enemy and collectible billboards
+    PHASE_MINIMAP,
+    PHASE_HUD,
+    PHASE_PRESENT,      // EndDrawing: buffer swap and frame limiter wait
+    PHASE_COUNT
+};
+
+const int PHASE_OTHER = PHASE_COUNT; // Outside every scope (allocation tracking)
+
+const int PROFILE_HISTORY = 512; // Frames kept in the ring buffer
+
+extern bool profilerEnabled;
+extern thread_local bool profilerThread; // Set on the thread that calls BeginProfileFrame
+extern thread_local int profilePhase;    // Innermost active scope's phase, else PHASE_OTHER
+extern bool profilerCounters;            // Hardware counters are being recorded
+
+void SetProfilerEnabled(bool enabled);
+
+// Record hardware counters per phase and per frame. Call on the profiling
+// thread; returns false (and records nothing) if the counters are
+// unavailable there.
+bool SetProfilerCounters(bool enabled);
+
+// Close the previous frame (recording its total time) and start a new one
+void BeginProfileFrame();
+
+// Add time to a phase in the current frame
+void AddProfileTime(ProfilePhase phase, double seconds);
+
+// Add counts from start until now to a phase in the current frame
+void AddProfileCounters(ProfilePhase phase, const PerfSample& start);
+
+// Record the current frame's sim-to-present interval: from the end of its
+// simulation ticks until its buffer swap returned. Not a phase (it overlaps
+// rendering), reported on its own row.
+void SetProfileSimToPresent(double seconds);
+
+// Times the enclosing scope into phase
+struct ProfileScope {
+    ProfilePhase phase;
+    bool active; // Enabled state at entry, so toggling mid-scope is safe
+    bool counting; // Hardware counters were read at entry
+    int outerPhase;
+    std::chrono::steady_clock::time_point start;
+    PerfSample counterStart;
+    
+    explicit ProfileScope(ProfilePhase phase) : phase(phase), active(profilerThread && profilerEnabled) {
+        if (active) {
+            outerPhase = profilePhase;
+            profilePhase = phase;
+            // Counters outside the clock reads, so their syscalls aren't timed
+            counting = profilerCounters && ReadPerfCounters(&counterStart);
+            start = std::chrono::steady_clock::now();
+        }
+    }
+    ~ProfileScope() {
+        if (active) {
+            AddProfileTime(phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            if (counting) AddProfileCounters(phase, counterStart);
+            profilePhase = outerPhase;
+        }
+    }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(phase) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(phase)
+
+// Per-phase rolling averages and p99, plus a frame-time graph, drawn with
+// its bottom-right corner at (right, bottom)
+void DrawProfilerOverlay(int right, int bottom);
+
+// Write the recorded frames (oldest first) as CSV, times in ms. Once
+// counters have been recorded it adds cycles, IPC and misses per thousand
+// instructions for the frame and each phase (empty where not counted).
+bool WriteProfileCsv(const char* path);
+
+#endif
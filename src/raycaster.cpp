@@ -0,0 +1,93 @@
+#include "raycaster.h"
+#include "map.h"
+#include <cmath>
+#include <algorithm>
+
+void BeginVisibleCells(VisibleCellSet* visible) {
+    size_t cellCount = (size_t)currentMapWidth * currentMapHeight;
+    if (visible->stamp.size() != cellCount) {
+        visible->stamp.assign(cellCount, 0);
+        visible->cells.reserve(cellCount); // Each cell is listed at most once, so frames never grow it
+    }
+    if (++visible->frame == 0) {
+        std::fill(visible->stamp.begin(), visible->stamp.end(), 0);
+        visible->frame = 1;
+    }
+    visible->cells.clear();
+}
+
+void GrowVisibleCells(VisibleCellSet* visible) {
+    size_t rayCells = visible->cells.size();
+    int width = currentMapWidth;
+    int height = currentMapHeight;
+    for (size_t i = 0; i < rayCells; i++) {
+        int x = visible->cells[i] % width;
+        int y = visible->cells[i] / width;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                MarkVisibleCell(visible, x + dx, y + dy, width, height);
+            }
+        }
+    }
+}
+
+int CastRays(Vector2 position, float angle, float fov, int columns, RayHit* hits, VisibleCellSet* visible) {
+    int steps = 0;
+    float planeScale = tanf(fov / 2.0f);
+    MapView map = GetCurrentMapView();
+    for (int x = 0; x < columns; x++) {
+        float cameraX = 2.0f * x / (float)columns - 1.0f;
+        float rayAngle = angle + atanf(cameraX * planeScale);
+        
+        Vector2 rayDir = { cosf(rayAngle), sinf(rayAngle) };
+        
+        int mapX = (int)position.x;
+        int mapY = (int)position.y;
+        
+        float deltaDistX = (rayDir.x == 0) ? 1e30f : fabsf(1.0f / rayDir.x);
+        float deltaDistY = (rayDir.y == 0) ? 1e30f : fabsf(1.0f / rayDir.y);
+        
+        int stepX = (rayDir.x < 0) ? -1 : 1;
+        int stepY = (rayDir.y < 0) ? -1 : 1;
+        
+        float sideDistX = (rayDir.x < 0)
+            ? (position.x - mapX) * deltaDistX
+            : (mapX + 1.0f - position.x) * deltaDistX;
+        float sideDistY = (rayDir.y < 0)
+            ? (position.y - mapY) * deltaDistY
+            : (mapY + 1.0f - position.y) * deltaDistY;
+        
+        int tile = 0;
+        bool side = false;
+        
+        while (tile == 0) {
+            if (sideDistX < sideDistY) {
+                sideDistX += deltaDistX;
+                mapX += stepX;
+                side = false;
+            } else {
+                sideDistY += deltaDistY;
+                mapY += stepY;
+                side = true;
+            }
+            steps++;
+            
+            tile = GetMapTile(map, mapX, mapY);
+            if (tile == 0 && visible) {
+                MarkVisibleCell(visible, mapX, mapY, map.width, map.height);
+            }
+        }
+        
+        float perpWallDist = !side
+            ? (mapX - position.x + (float)(1 - stepX) / 2) / rayDir.x
+            : (mapY - position.y + (float)(1 - stepY) / 2) / rayDir.y;
+        if (perpWallDist < 0.1f) perpWallDist = 0.1f;
+        
+        hits[x].distance = perpWallDist;
+        hits[x].mapX = mapX;
+        hits[x].mapY = mapY;
+        hits[x].tile = tile;
+        hits[x].side = side;
+    }
+    return steps;
+}
@@ -0,0 +1,51 @@
+#ifndef RAYCASTER_H
+#define RAYCASTER_H
+
+#include <raylib.h>
+#include <cmath>
+#include <vector>
+
+// What one screen column's ray hit
+struct RayHit {
+    float distance; // Perpendicular wall distance (fisheye corrected, at least 0.1)
+    int mapX;       // Tile that stopped the ray
+    int mapY;
+    int tile;
+    bool side;      // True if it hit a north/south face
+};
+
+// Map cells reached by the rays this frame, used to cull collectible buckets.
+// Stamps make clearing O(1) per frame.
+struct VisibleCellSet {
+    std::vector<unsigned int> stamp;
+    std::vector<int> cells;
+    unsigned int frame;
+};
+
+// Start a new frame for the current map
+void BeginVisibleCells(VisibleCellSet* visible);
+
+inline void MarkVisibleCell(VisibleCellSet* visible, int x, int y, int mapWidth, int mapHeight) {
+    if (x < 0 || x >= mapWidth || y < 0 || y >= mapHeight) return;
+    int cell = y * mapWidth + x;
+    if (visible->stamp[cell] == visible->frame) return;
+    visible->stamp[cell] = visible->frame;
+    visible->cells.push_back(cell);
+}
+
+// Add a one-cell border so sprites overhanging from hidden cells still draw
+void GrowVisibleCells(VisibleCellSet* visible);
+
+// Pixels a unit-sized object spans at distance 1 when fov spans columns. Walls
+// and sprites all scale by it, so the view keeps its proportions at any
+// window size and sprites land on the columns their rays would.
+inline float GetFocalLength(float fov, int columns) {
+    return columns / 2.0f / tanf(fov / 2.0f);
+}
+
+// DDA-cast one ray per column across fov on the current map, filling
+// hits[columns]. Empty cells the rays cross are marked in visible (may be
+// null). Returns the number of cells stepped through.
+int CastRays(Vector2 position, float angle, float fov, int columns, RayHit* hits, VisibleCellSet* visible);
+
+#endif
@@ -0,0 +1,199 @@
+#include "replay.h"
+#include <string.h>
+
+enum ReplayButton {
+    BUTTON_FORWARD = 1 << 0,
+    BUTTON_BACK = 1 << 1,
+    BUTTON_LEFT = 1 << 2,
+    BUTTON_RIGHT = 1 << 3,
+    BUTTON_UP = 1 << 4,
+    BUTTON_DOWN = 1 << 5,
+    BUTTON_ENTER = 1 << 6,
+    BUTTON_SPACE = 1 << 7,
+    BUTTON_RESTART = 1 << 8,
+    BUTTON_PERK1 = 1 << 9,
+    BUTTON_PERK2 = 1 << 10,
+    BUTTON_PERK3 = 1 << 11,
+    BUTTON_LEVEL_READY = 1 << 12
+};
+
+static unsigned short PackButtons(const GameInput* input) {
+    unsigned short buttons = 0;
+    if (input->moveForward) buttons |= BUTTON_FORWARD;
+    if (input->moveBack) buttons |= BUTTON_BACK;
+    if (input->moveLeft) buttons |= BUTTON_LEFT;
+    if (input->moveRight) buttons |= BUTTON_RIGHT;
+    if (input->upPressed) buttons |= BUTTON_UP;
+    if (input->downPressed) buttons |= BUTTON_DOWN;
+    if (input->enterPressed) buttons |= BUTTON_ENTER;
+    if (input->spacePressed) buttons |= BUTTON_SPACE;
+    if (input->restartPressed) buttons |= BUTTON_RESTART;
+    if (input->perkPressed[0]) buttons |= BUTTON_PERK1;
+    if (input->perkPressed[1]) buttons |= BUTTON_PERK2;
+    if (input->perkPressed[2]) buttons |= BUTTON_PERK3;
+    if (input->levelReady) buttons |= BUTTON_LEVEL_READY;
+    return buttons;
+}
+
+static void UnpackButtons(unsigned short buttons, GameInput* input) {
+    input->moveForward = (buttons & BUTTON_FORWARD) != 0;
+    input->moveBack = (buttons & BUTTON_BACK) != 0;
+    input->moveLeft = (buttons & BUTTON_LEFT) != 0;
+    input->moveRight = (buttons & BUTTON_RIGHT) != 0;
+    input->upPressed = (buttons & BUTTON_UP) != 0;
+    input->downPressed = (buttons & BUTTON_DOWN) != 0;
+    input->enterPressed = (buttons & BUTTON_ENTER) != 0;
+    input->spacePressed = (buttons & BUTTON_SPACE) != 0;
+    input->restartPressed = (buttons & BUTTON_RESTART) != 0;
+    input->perkPressed[0] = (buttons & BUTTON_PERK1) != 0;
+    input->perkPressed[1] = (buttons & BUTTON_PERK2) != 0;
+    input->perkPressed[2] = (buttons & BUTTON_PERK3) != 0;
+    input->levelReady = (buttons & BUTTON_LEVEL_READY) != 0;
+}
+
+bool StartReplayRecording(Replay* replay, const char* path, unsigned int seed) {
+    memset(replay, 0, sizeof(*replay));
+    replay->file = fopen(path, "wb");
+    if (replay->file == NULL) {
+        TraceLog(LOG_ERROR, "Replay: cannot write %s", path);
+        return false;
+    }
+    
+    ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_VERSION;
+    header.seed = seed;
+    header.tickRate = (unsigned int)SIM_TICK_RATE;
+    fwrite(&header, sizeof(header), 1, replay->file);
+    
+    replay->mode = REPLAY_RECORD;
+    replay->seed = seed;
+    TraceLog(LOG_INFO, "Replay: recording to %s (seed %u)", path, seed);
+    return true;
+}
+
+bool StartReplayPlayback(Replay* replay, const char* path) {
+    memset(replay, 0, sizeof(*replay));
+    replay->file = fopen(path, "rb");
+    if (replay->file == NULL) {
+        TraceLog(LOG_ERROR, "Replay: cannot read %s", path);
+        return false;
+    }
+    
+    ReplayHeader header;
+    bool valid = fread(&header, sizeof(header), 1, replay->file) == 1 &&
+                 memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == REPLAY_VERSION &&
+                 header.tickRate == (unsigned int)SIM_TICK_RATE;
+    if (!valid) {
+        TraceLog(LOG_ERROR, "Replay: %s is not a compatible recording", path);
+        fclose(replay->file);
+        replay->file = NULL;
+        return false;
+    }
+    
+    replay->mode = REPLAY_PLAYBACK;
+    replay->seed = header.seed;
+    TraceLog(LOG_INFO, "Replay: playing %s (seed %u)", path, header.seed);
+    return true;
+}
+
+bool ReadReplayTick(Replay* replay, GameInput* input) {
+    if (replay->mode != REPLAY_PLAYBACK || replay->finished) return false;
+    
+    unsigned char bytes[REPLAY_TICK_BYTES];
+    if (fread(bytes, 1, sizeof(bytes), replay->file) != sizeof(bytes)) {
+        replay->finished = true;
+        return false;
+    }
+    unsigned short buttons;
+    memcpy(&buttons, bytes, 2);
+    memcpy(&input->lookDelta, bytes + 2, 4);
+    memcpy(&replay->expectedHash, bytes + 6, 4);
+    UnpackButtons(buttons, input);
+    return true;
+}
+
+void EndReplayTick(Replay* replay, const GameInput* input, unsigned int stateHash) {
+    if (replay->mode == REPLAY_RECORD) {
+        unsigned char bytes[REPLAY_TICK_BYTES];
+        unsigned short buttons = PackButtons(input);
+        memcpy(bytes, &buttons, 2);
+        memcpy(bytes + 2, &input->lookDelta, 4);
+        memcpy(bytes + 6, &stateHash, 4);
+        fwrite(bytes, 1, sizeof(bytes), replay->file);
+    } else if (replay->mode == REPLAY_PLAYBACK) {
+        // Report only the first mismatch; everything after it follows from it
+        if (stateHash != replay->expectedHash && !replay->diverged) {
+            replay->diverged = true;
+            replay->divergedTick = replay->tick;
+            TraceLog(LOG_WARNING, "Replay: state diverged at tick %u", replay->tick);
+        }
+    } else {
+        return;
+    }
+    replay->tick++;
+}
+
+void CloseReplay(Replay* replay) {
+    if (replay->mode == REPLAY_RECORD) {
+        TraceLog(LOG_INFO, "Replay: recorded %u ticks", replay->tick);
+    } else if (replay->mode == REPLAY_PLAYBACK) {
+        if (replay->diverged) {
+            TraceLog(LOG_WARNING, "Replay: played %u ticks, diverged at tick %u", replay->tick, replay->divergedTick);
+        } else {
+            TraceLog(LOG_INFO, "Replay: played %u ticks, state identical", replay->tick);
+        }
+    }
+    if (replay->file) {
+        fclose(replay->file);
+    }
+    memset(replay, 0, sizeof(*replay));
+}
+
+// FNV-1a over raw bytes; floats are compared bit for bit on purpose
+static unsigned int HashBytes(unsigned int hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template <typename T>
+static unsigned int HashValue(unsigned int hash, const T& value) {
+    return HashBytes(hash, &value, sizeof(value));
+}
+
+unsigned int HashGameState(const GameState* game) {
+    unsigned int hash = 2166136261u;
+    hash = HashValue(hash, (int)game->mode);
+    hash = HashValue(hash, game->currentLevel);
+    hash = HashValue(hash, game->totalGold);
+    hash = HashValue(hash, game->doorCost);
+    hash = HashValue(hash, game->menuSelection);
+    hash = HashValue(hash, game->selectedPerk);
+    hash = HashValue(hash, game->stabEffectTimer);
+    hash = HashValue(hash, game->rng.state);
+    
+    const Player* player = &game->player;
+    hash = HashValue(hash, player->position);
+    hash = HashValue(hash, player->angle);
+    hash = HashValue(hash, player->moveSpeed);
+    hash = HashValue(hash, player->boostTimer);
+    hash = HashValue(hash, player->goldMultiplier);
+    
+    const Enemy* enemy = &game->enemy;
+    hash = HashValue(hash, enemy->position);
+    hash = HashValue(hash, enemy->isActive);
+    hash = HashValue(hash, enemy->isChasing);
+    hash = HashValue(hash, enemy->currentPathIndex);
+    
+    const CollectibleStore* store = &game->collectibles;
+    if (!store->alive.empty()) {
+        hash = HashBytes(hash, store->alive.data(), store->alive.size() * sizeof(store->alive[0]));
+    }
+    return hash;
+}
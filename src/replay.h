@@ -0,0 +1,62 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include "game.h"
+
+// Input recording for reproducible runs. A replay file holds the RNG seed
+// and, for every simulation tick, the GameInput that tick consumed plus a
+// hash of the state it produced. Playing it back feeds the same inputs
+// through UpdateGame, so the run (and its cost) is identical tick for tick.
+// Layout: ReplayHeader, then REPLAY_TICK_BYTES per tick (buttons u16,
+// lookDelta f32, stateHash u32). All fields little-endian.
+
+#define REPLAY_MAGIC "LD58REP"
+const unsigned int REPLAY_VERSION = 2;
+const int REPLAY_TICK_BYTES = 10;
+
+struct ReplayHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int seed;
+    unsigned int tickRate; // SIM_TICK_RATE the run was recorded at
+};
+
+enum ReplayMode {
+    REPLAY_OFF,
+    REPLAY_RECORD,
+    REPLAY_PLAYBACK
+};
+
+struct Replay {
+    ReplayMode mode;
+    FILE* file;
+    unsigned int seed;
+    unsigned int tick;         // Ticks written or read so far
+    unsigned int expectedHash; // Playback: recorded hash for the current tick
+    bool finished;             // Playback: no ticks left
+    bool diverged;             // Playback: a state hash did not match
+    unsigned int divergedTick;
+};
+
+// Open path for writing and store the seed. Returns false (replay off) on error.
+bool StartReplayRecording(Replay* replay, const char* path, unsigned int seed);
+
+// Open a recording for playback; replay->seed is the seed to start from.
+// Returns false (replay off) if the file is missing or invalid.
+bool StartReplayPlayback(Replay* replay, const char* path);
+
+// Playback: load the next tick's input. Returns false once the recording
+// is exhausted (replay->finished is then set).
+bool ReadReplayTick(Replay* replay, GameInput* input);
+
+// After a tick: record its input and state hash, or check the hash in playback
+void EndReplayTick(Replay* replay, const GameInput* input, unsigned int stateHash);
+
+// Close the file and log a summary
+void CloseReplay(Replay* replay);
+
+// Hash of the simulated state (not render-only fields like sprites)
+unsigned int HashGameState(const GameState* game);
+
+#endif
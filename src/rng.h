@@ -0,0 +1,39 @@
+#ifndef RNG_H
+#define RNG_H
+
+// Small deterministic generator (xorshift32) with explicit state, so
+// generation code can be seeded, replayed and run off the main thread
+struct Rng {
+    unsigned int state;
+};
+
+inline void SeedRng(Rng* rng, unsigned int seed) {
+    // Scramble so nearby seeds give unrelated sequences; state must be non-zero
+    seed ^= seed >> 16;
+    seed *= 0x7FEB352Du;
+    seed ^= seed >> 15;
+    seed *= 0x846CA68Bu;
+    seed ^= seed >> 16;
+    rng->state = seed ? seed : 0x9E3779B9u;
+}
+
+inline unsigned int NextRng(Rng* rng) {
+    unsigned int x = rng->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng->state = x;
+    return x;
+}
+
+// Uniform int in [0, n)
+inline int RngRange(Rng* rng, int n) {
+    return (int)(NextRng(rng) % (unsigned int)n);
+}
+
+// Uniform float in [0, 1)
+inline float RngFloat(Rng* rng) {
+    return (float)(NextRng(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include "simthread.h"
+#include "framepacer.h"
+#include "trace.h"
+#include <chrono>
+
+const int SIM_SLOT_FRESH = 4; // Set in middle when the sim has published since the last acquire
+
+double SimClock() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void PublishRenderState(SimThread* sim, double lookApplied) {
+    RenderState* state = &sim->slots[sim->back];
+    CaptureRenderState(sim->game, state);
+    state->tickTime = SimClock();
+    state->lookApplied = lookApplied;
+    sim->back = sim->middle.exchange(sim->back | SIM_SLOT_FRESH, std::memory_order_acq_rel) & 3;
+}
+
+static void SimThreadMain(SimThread* sim) {
+    SetTraceThreadName("simulation");
+    FramePacer pacer;
+    SetFramePacerRate(&pacer, (int)SIM_TICK_RATE);
+    GameInput input = {};
+    double lookApplied = 0.0;
+    while (sim->running.load(std::memory_order_acquire)) {
+        WaitNextFrame(&pacer);
+        if (sim->replay->mode == REPLAY_PLAYBACK) {
+            if (!ReadReplayTick(sim->replay, &input)) {
+                sim->finished.store(true, std::memory_order_release);
+                return;
+            }
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(sim->inputMutex);
+                input = sim->pendingInput;
+                sim->lookConsumed += input.lookDelta;
+                lookApplied = sim->lookConsumed;
+                ConsumeGameInput(&sim->pendingInput);
+            }
+            input.levelReady = IsLevelLoadReady(&sim->game->loader, sim->game->currentLevel);
+        }
+        UpdateGame(sim->game, &input, SIM_DT);
+        EndReplayTick(sim->replay, &input, HashGameState(sim->game));
+        PublishRenderState(sim, lookApplied);
+    }
+}
+
+void StartSimThread(SimThread* sim, GameState* game, Replay* replay) {
+    sim->game = game;
+    sim->replay = replay;
+    sim->running.store(true);
+    sim->finished.store(false);
+    sim->pendingInput = GameInput();
+    sim->lookConsumed = 0.0;
+    
+    // Something to draw before the first tick lands
+    sim->front = 0;
+    sim->back = 1;
+    sim->middle.store(2);
+    CaptureRenderState(game, &sim->slots[0]);
+    sim->slots[0].tickTime = SimClock();
+    sim->slots[0].lookApplied = 0.0;
+    
+    sim->thread = std::thread(SimThreadMain, sim);
+}
+
+void StopSimThread(SimThread* sim) {
+    sim->running.store(false, std::memory_order_release);
+    if (sim->thread.joinable()) sim->thread.join();
+}
+
+float SubmitSimInput(SimThread* sim, const RenderState* shown) {
+    std::lock_guard<std::mutex> lock(sim->inputMutex);
+    PollGameInput(&sim->pendingInput);
+    return (float)(sim->lookConsumed + sim->pendingInput.lookDelta - shown->lookApplied);
+}
+
+const RenderState* AcquireRenderState(SimThread* sim) {
+    if (sim->middle.load(std::memory_order_relaxed) & SIM_SLOT_FRESH) {
+        sim->front = sim->middle.exchange(sim->front, std::memory_order_acq_rel) & 3;
+    }
+    return &sim->slots[sim->front];
+}
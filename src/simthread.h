@@ -0,0 +1,55 @@
+#ifndef SIMTHREAD_H
+#define SIMTHREAD_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "game.h"
+#include "replay.h"
+
+// Pipelined mode: the fixed-step simulation runs on its own thread at
+// SIM_TICK_RATE and publishes a RenderState after every tick, while the main
+// thread polls input and renders the newest one. A frame then costs
+// max(update, render) instead of their sum.
+//
+// Hand-off is a lock-free triple buffer: the sim thread always has a back
+// slot to write, the renderer always has a front slot to read, and the middle
+// slot is swapped atomically between them, so neither ever waits on the other.
+// Input goes the other way under a mutex held only to copy a GameInput.
+
+struct SimThread {
+    GameState* game;
+    Replay* replay;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> finished; // Replay playback ran out
+    
+    // Input polled by the main thread, taken by the next tick
+    std::mutex inputMutex;
+    GameInput pendingInput;
+    double lookConsumed;        // Total lookDelta taken by ticks so far
+    
+    RenderState slots[3];
+    std::atomic<int> middle;    // Slot index, plus SIM_SLOT_FRESH once published
+    int back;                   // Sim thread's slot
+    int front;                  // Renderer's slot
+};
+
+// Steady clock shared by both threads (seconds)
+double SimClock();
+
+// Publish game's current state and start ticking it. From here until
+// StopSimThread only the sim thread touches game and replay.
+void StartSimThread(SimThread* sim, GameState* game, Replay* replay);
+
+// Stop ticking and join; game and replay belong to the caller again
+void StopSimThread(SimThread* sim);
+
+// Poll this frame's input into the pending input. Returns the mouse look
+// polled so far that shown's tick had not yet applied.
+float SubmitSimInput(SimThread* sim, const RenderState* shown);
+
+// Newest published state (renderer thread only). Valid until the next call.
+const RenderState* AcquireRenderState(SimThread* sim);
+
+#endif
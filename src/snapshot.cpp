@@ -0,0 +1,380 @@
+#include "snapshot.h"
+#include "game.h"
+#include "map.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SNAPSHOT_MAGIC "LD58SNP"
+const unsigned int SNAPSHOT_VERSION = 1;
+
+// An array inside the snapshot
+struct SnapshotSpan {
+    unsigned int offset; // Bytes from the start of the snapshot
+    unsigned int count;  // Elements
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int headerSize;
+    unsigned int totalSize;
+    int mapLevel; // Bundled level whose map was current, 0 if another map
+    
+    // Game
+    int mode;
+    int currentLevel;
+    int totalGold;
+    int doorCost;
+    int selectedPerk;
+    int menuSelection;
+    float animTime;
+    float FOV;
+    float stabEffectTimer;
+    bool isBeingAttacked;
+    bool shopContinuePressed;
+    bool showEnemyOnMinimap;
+    bool jumpscareLooping;
+    unsigned int rngState;
+    int perkType[3]; // Names come back from DescribePerk
+    int perkCost[3];
+    float perkValue[3];
+    Player player;
+    
+    // Enemy and its planner
+    Vector2 enemyPosition;
+    Vector2 enemyPrevPosition;
+    float enemySpeed;
+    float enemyDetectionRange;
+    float enemyAttackRange;
+    float enemyPathRecalcTimer;
+    int enemyPathIndex;
+    bool enemyActive;
+    bool enemyChasing;
+    bool plannerValid;
+    int plannerWidth;
+    int plannerHeight;
+    int plannerAnchorCell;
+    int plannerTargetCell;
+    float plannerKm;
+    int plannerNodesTouched;
+    int plannerRebuildCount;
+    SnapshotSpan enemyPath;   // Vector2
+    SnapshotSpan plannerG;    // float
+    SnapshotSpan plannerRhs;  // float
+    SnapshotSpan plannerOpen; // PlannerEntry
+    
+    // Collectibles
+    int itemCount;
+    int itemGridWidth;
+    int itemGridHeight;
+    SnapshotSpan itemX;       // float
+    SnapshotSpan itemY;       // float
+    SnapshotSpan itemValue;   // float
+    SnapshotSpan itemType;    // unsigned char
+    SnapshotSpan itemAlive;   // unsigned long long
+    SnapshotSpan itemCellStart; // int
+};
+
+static size_t AlignSnapshot(size_t size) {
+    return (size + 7) & ~(size_t)7;
+}
+
+// Lay out count elements of elementSize at *size
+static SnapshotSpan ReserveSpan(size_t* size, size_t count, size_t elementSize) {
+    SnapshotSpan span = { (unsigned int)*size, (unsigned int)count };
+    *size = AlignSnapshot(*size + count * elementSize);
+    return span;
+}
+
+template <typename Vector>
+static void WriteSpan(unsigned char* data, SnapshotSpan span, const Vector& values) {
+    if (span.count > 0) memcpy(data + span.offset, values.data(), span.count * sizeof(values[0]));
+}
+
+template <typename Vector>
+static void ReadSpan(const unsigned char* data, SnapshotSpan span, Vector& values) {
+    typedef typename Vector::value_type T;
+    const T* first = (const T*)(data + span.offset);
+    values.assign(first, first + span.count);
+}
+
+static bool SpanFits(SnapshotSpan span, size_t elementSize, size_t totalSize) {
+    return span.offset >= sizeof(SnapshotHeader) && span.offset % 8 == 0 &&
+           span.offset <= totalSize && span.count <= (totalSize - span.offset) / elementSize;
+}
+
+// Check that the arrays agree with each other and with the map being restored,
+// so nothing indexes past them once they're back in game. Spans already fit.
+static bool IsSnapshotConsistent(const SnapshotHeader& header, const unsigned char* data) {
+    // Levels past the last one only exist as the won screen
+    int lastLevel = header.mode == GAME_WON ? MAX_LEVELS + 1 : MAX_LEVELS;
+    if (header.currentLevel < 1 || header.currentLevel > lastLevel) return false;
+    
+    // Without a bundled map there's nothing to play on or to check against, so
+    // only the screens that don't show the world can be restored
+    int mapWidth = 0;
+    int mapHeight = 0;
+    if (header.mapLevel > 0) {
+        GetLevelMap(header.mapLevel, &mapWidth, &mapHeight);
+    } else if (header.mode == PLAYING || header.mode == SHOP) {
+        return false;
+    }
+    
+    // Planner: one g and rhs per map cell, every cell it refers to inside. An
+    // invalid planner is rebuilt before its arrays are read again, and its
+    // heap is always empty.
+    if (!header.plannerValid) {
+        if (header.plannerOpen.count != 0) return false;
+    } else {
+        long long plannerCells = (long long)header.plannerWidth * header.plannerHeight;
+        if (header.mapLevel == 0 || header.plannerWidth != mapWidth || header.plannerHeight != mapHeight ||
+            header.plannerG.count != plannerCells || header.plannerRhs.count != plannerCells ||
+            header.plannerAnchorCell < 0 || header.plannerAnchorCell >= plannerCells ||
+            header.plannerTargetCell < 0 || header.plannerTargetCell >= plannerCells) {
+            return false;
+        }
+        const PlannerEntry* open = (const PlannerEntry*)(data + header.plannerOpen.offset);
+        for (unsigned int i = 0; i < header.plannerOpen.count; i++) {
+            if (open[i].cell < 0 || open[i].cell >= plannerCells) return false;
+        }
+    }
+    if (header.enemyPathIndex < 0 || (unsigned int)header.enemyPathIndex > header.enemyPath.count) return false;
+    
+    // Collectibles: every array holds count items, the alive bitset covers
+    // them, and the cell offsets cover the map and rise to count
+    if (header.itemCount < 0) return false;
+    unsigned int count = (unsigned int)header.itemCount;
+    if (header.itemX.count != count || header.itemY.count != count || header.itemValue.count != count ||
+        header.itemType.count != count || header.itemAlive.count != (count + 63) / 64) {
+        return false;
+    }
+    long long itemCells = (long long)header.itemGridWidth * header.itemGridHeight;
+    if (itemCells == 0) return count == 0 && header.itemCellStart.count == 0;
+    if (header.itemGridWidth != mapWidth || header.itemGridHeight != mapHeight) return false;
+    if (header.itemCellStart.count != itemCells + 1) return false;
+    const int* cellStart = (const int*)(data + header.itemCellStart.offset);
+    if (cellStart[0] != 0 || cellStart[itemCells] != header.itemCount) return false;
+    for (long long c = 0; c < itemCells; c++) {
+        if (cellStart[c] > cellStart[c + 1]) return false;
+    }
+    return true;
+}
+
+bool CaptureGameSnapshot(const GameState* game, GameSnapshot* snapshot) {
+    if (game->mode == LOADING) return false;
+    const Enemy& enemy = game->enemy;
+    const CollectibleStore& items = game->collectibles;
+    
+    SnapshotHeader header = {};
+    size_t size = AlignSnapshot(sizeof(SnapshotHeader));
+    header.enemyPath = ReserveSpan(&size, enemy.path.size(), sizeof(Vector2));
+    header.plannerG = ReserveSpan(&size, enemy.planner.g.size(), sizeof(float));
+    header.plannerRhs = ReserveSpan(&size, enemy.planner.rhs.size(), sizeof(float));
+    header.plannerOpen = ReserveSpan(&size, enemy.planner.open.size(), sizeof(PlannerEntry));
+    header.itemX = ReserveSpan(&size, items.x.size(), sizeof(float));
+    header.itemY = ReserveSpan(&size, items.y.size(), sizeof(float));
+    header.itemValue = ReserveSpan(&size, items.value.size(), sizeof(float));
+    header.itemType = ReserveSpan(&size, items.type.size(), sizeof(unsigned char));
+    header.itemAlive = ReserveSpan(&size, items.alive.size(), sizeof(unsigned long long));
+    header.itemCellStart = ReserveSpan(&size, items.cellStart.size(), sizeof(int));
+    
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.totalSize = (unsigned int)size;
+    header.mapLevel = 0;
+    for (int level = 1; level <= MAX_LEVELS; level++) {
+        int width, height;
+        if (GetLevelMap(level, &width, &height) == currentMap) {
+            header.mapLevel = level;
+            break;
+        }
+    }
+    
+    header.mode = game->mode;
+    header.currentLevel = game->currentLevel;
+    header.totalGold = game->totalGold;
+    header.doorCost = game->doorCost;
+    header.selectedPerk = game->selectedPerk;
+    header.menuSelection = game->menuSelection;
+    header.animTime = game->animTime;
+    header.FOV = game->FOV;
+    header.stabEffectTimer = game->stabEffectTimer;
+    header.isBeingAttacked = game->isBeingAttacked;
+    header.shopContinuePressed = game->shopContinuePressed;
+    header.showEnemyOnMinimap = game->showEnemyOnMinimap;
+    header.jumpscareLooping = game->jumpscareLooping;
+    header.rngState = game->rng.state;
+    for (int i = 0; i < 3; i++) {
+        header.perkType[i] = game->shopPerks[i].type;
+        header.perkCost[i] = game->shopPerks[i].cost;
+        header.perkValue[i] = game->shopPerks[i].value;
+    }
+    header.player = game->player;
+    
+    header.enemyPosition = enemy.position;
+    header.enemyPrevPosition = enemy.prevPosition;
+    header.enemySpeed = enemy.speed;
+    header.enemyDetectionRange = enemy.detectionRange;
+    header.enemyAttackRange = enemy.attackRange;
+    header.enemyPathRecalcTimer = enemy.pathRecalcTimer;
+    header.enemyPathIndex = enemy.currentPathIndex;
+    header.enemyActive = enemy.isActive;
+    header.enemyChasing = enemy.isChasing;
+    header.plannerValid = enemy.planner.valid;
+    header.plannerWidth = enemy.planner.width;
+    header.plannerHeight = enemy.planner.height;
+    header.plannerAnchorCell = enemy.planner.anchorCell;
+    header.plannerTargetCell = enemy.planner.targetCell;
+    header.plannerKm = enemy.planner.km;
+    header.plannerNodesTouched = enemy.planner.nodesTouched;
+    header.plannerRebuildCount = enemy.planner.rebuildCount;
+    
+    header.itemCount = items.count;
+    header.itemGridWidth = items.gridWidth;
+    header.itemGridHeight = items.gridHeight;
+    
+    snapshot->data.resize(size);
+    unsigned char* data = snapshot->data.data();
+    memcpy(data, &header, sizeof(header));
+    WriteSpan(data, header.enemyPath, enemy.path);
+    WriteSpan(data, header.plannerG, enemy.planner.g);
+    WriteSpan(data, header.plannerRhs, enemy.planner.rhs);
+    WriteSpan(data, header.plannerOpen, enemy.planner.open);
+    WriteSpan(data, header.itemX, items.x);
+    WriteSpan(data, header.itemY, items.y);
+    WriteSpan(data, header.itemValue, items.value);
+    WriteSpan(data, header.itemType, items.type);
+    WriteSpan(data, header.itemAlive, items.alive);
+    WriteSpan(data, header.itemCellStart, items.cellStart);
+    return true;
+}
+
+bool RestoreGameSnapshot(GameState* game, const GameSnapshot* snapshot) {
+    return RestoreGameSnapshotBytes(game, snapshot->data.data(), snapshot->data.size());
+}
+
+bool RestoreGameSnapshotBytes(GameState* game, const void* bytes, size_t size) {
+    // Check everything before touching game
+    if (bytes == NULL || size < sizeof(SnapshotHeader)) return false;
+    const unsigned char* data = (const unsigned char*)bytes;
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION || header.headerSize != sizeof(SnapshotHeader) ||
+        header.totalSize > size || header.mapLevel < 0 || header.mapLevel > MAX_LEVELS ||
+        header.mode < MAIN_MENU || header.mode > GAME_LOST || header.mode == LOADING) {
+        return false;
+    }
+    if (((size_t)data & 7) != 0) return false; // Arrays are read in place
+    size_t total = header.totalSize;
+    if (!SpanFits(header.enemyPath, sizeof(Vector2), total) ||
+        !SpanFits(header.plannerG, sizeof(float), total) ||
+        !SpanFits(header.plannerRhs, sizeof(float), total) ||
+        !SpanFits(header.plannerOpen, sizeof(PlannerEntry), total) ||
+        !SpanFits(header.itemX, sizeof(float), total) ||
+        !SpanFits(header.itemY, sizeof(float), total) ||
+        !SpanFits(header.itemValue, sizeof(float), total) ||
+        !SpanFits(header.itemType, sizeof(unsigned char), total) ||
+        !SpanFits(header.itemAlive, sizeof(unsigned long long), total) ||
+        !SpanFits(header.itemCellStart, sizeof(int), total)) {
+        return false;
+    }
+    if (!IsSnapshotConsistent(header, data)) return false;
+    
+    // A load started after the capture belongs to a future that no longer happens
+    CancelLevelLoad(&game->loader);
+    // Without a bundled map the screen doesn't show the world (checked above),
+    // so the current map is left alone
+    if (header.mapLevel > 0) {
+        int width, height;
+        const int* map = GetLevelMap(header.mapLevel, &width, &height);
+        SetCurrentMap(map, width, height);
+    }
+    
+    game->mode = (GameMode)header.mode;
+    game->currentLevel = header.currentLevel;
+    game->totalGold = header.totalGold;
+    game->doorCost = header.doorCost;
+    game->selectedPerk = header.selectedPerk;
+    game->menuSelection = header.menuSelection;
+    game->animTime = header.animTime;
+    game->FOV = header.FOV;
+    game->stabEffectTimer = header.stabEffectTimer;
+    game->isBeingAttacked = header.isBeingAttacked;
+    game->shopContinuePressed = header.shopContinuePressed;
+    game->showEnemyOnMinimap = header.showEnemyOnMinimap;
+    game->jumpscareLooping = header.jumpscareLooping;
+    game->rng.state = header.rngState;
+    for (int i = 0; i < 3; i++) {
+        game->shopPerks[i].type = header.perkType[i];
+        game->shopPerks[i].cost = header.perkCost[i];
+        game->shopPerks[i].value = header.perkValue[i];
+        DescribePerk(&game->shopPerks[i]);
+    }
+    game->player = header.player;
+    
+    Enemy& enemy = game->enemy;
+    enemy.position = header.enemyPosition;
+    enemy.prevPosition = header.enemyPrevPosition;
+    enemy.speed = header.enemySpeed;
+    enemy.detectionRange = header.enemyDetectionRange;
+    enemy.attackRange = header.enemyAttackRange;
+    enemy.pathRecalcTimer = header.enemyPathRecalcTimer;
+    enemy.currentPathIndex = header.enemyPathIndex;
+    enemy.isActive = header.enemyActive;
+    enemy.isChasing = header.enemyChasing;
+    enemy.planner.valid = header.plannerValid;
+    enemy.planner.width = header.plannerWidth;
+    enemy.planner.height = header.plannerHeight;
+    enemy.planner.anchorCell = header.plannerAnchorCell;
+    enemy.planner.targetCell = header.plannerTargetCell;
+    enemy.planner.km = header.plannerKm;
+    enemy.planner.nodesTouched = header.plannerNodesTouched;
+    enemy.planner.rebuildCount = header.plannerRebuildCount;
+    ReadSpan(data, header.enemyPath, enemy.path);
+    ReadSpan(data, header.plannerG, enemy.planner.g);
+    ReadSpan(data, header.plannerRhs, enemy.planner.rhs);
+    ReadSpan(data, header.plannerOpen, enemy.planner.open);
+    
+    CollectibleStore& items = game->collectibles;
+    items.count = header.itemCount;
+    items.gridWidth = header.itemGridWidth;
+    items.gridHeight = header.itemGridHeight;
+    ReadSpan(data, header.itemX, items.x);
+    ReadSpan(data, header.itemY, items.y);
+    ReadSpan(data, header.itemValue, items.value);
+    ReadSpan(data, header.itemType, items.type);
+    ReadSpan(data, header.itemAlive, items.alive);
+    ReadSpan(data, header.itemCellStart, items.cellStart);
+    return true;
+}
+
+bool SaveGameSnapshot(const GameSnapshot* snapshot, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        TraceLog(LOG_ERROR, "Snapshot: cannot write %s", path);
+        return false;
+    }
+    bool ok = fwrite(snapshot->data.data(), 1, snapshot->data.size(), file) == snapshot->data.size();
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+
+bool LoadGameSnapshot(GameSnapshot* snapshot, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        TraceLog(LOG_ERROR, "Snapshot: cannot open %s", path);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    bool ok = size >= 0;
+    if (ok) {
+        snapshot->data.resize((size_t)size);
+        ok = fread(snapshot->data.data(), 1, (size_t)size, file) == (size_t)size;
+    }
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,40 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include <vector>
+
+struct GameState;
+
+// Flat binary copy of everything mutable in a GameState: player, enemy with
+// its path and planner, collectibles, RNG, mode, timers, shop and the map in
+// use. Sprites and any in-flight level load are not included.
+// Layout: SnapshotHeader (snapshot.cpp), then the arrays it points to, each
+// 8-byte aligned. Offsets are from the start of the snapshot, so a file
+// written with SaveGameSnapshot can be memory-mapped and restored in place.
+// Only valid for the build that wrote it (headerSize guards the layout).
+
+// Snapshot bytes. Capturing into the same GameSnapshot again reuses its
+// buffer, so repeated captures don't allocate.
+struct GameSnapshot {
+    std::vector<unsigned char> data;
+};
+
+// Copy game into snapshot. Returns false while a level is loading (the
+// background build can't be captured).
+bool CaptureGameSnapshot(const GameState* game, GameSnapshot* snapshot);
+
+// Put game back to the captured state, cancelling any level load and making
+// the captured map current. Returns false (game untouched) if the snapshot is
+// empty, invalid, or its arrays don't agree with each other or the map.
+bool RestoreGameSnapshot(GameState* game, const GameSnapshot* snapshot);
+
+// Same, straight from snapshot bytes (e.g. a memory-mapped file)
+bool RestoreGameSnapshotBytes(GameState* game, const void* data, size_t size);
+
+bool SaveGameSnapshot(const GameSnapshot* snapshot, const char* path);
+
+// Read a file written by SaveGameSnapshot (checked on restore)
+bool LoadGameSnapshot(GameSnapshot* snapshot, const char* path);
+
+#endif
@@ -0,0 +1,177 @@
+#include "sprites.h"
+#include <rlgl.h>
+
+static const int ATLAS_WIDTH = 1024;
+static const int ATLAS_PADDING = 2;
+
+// Baked sizes: coin/boost radius and enemy height, in pixels
+static const float COIN_SIZES[SPRITE_LEVELS] = {8.0f, 16.0f, 32.0f, 64.0f};
+static const float ENEMY_SIZES[SPRITE_LEVELS] = {64.0f, 128.0f, 256.0f, 512.0f};
+
+static int CoinTextSize(float radius) {
+    return radius < 12.0f ? 12 : (int)radius;
+}
+
+static const char* CoinLabel(int sprite) {
+    return sprite == SPRITE_COIN ? "$" : "2x Speed";
+}
+
+// Frame size and pivot for a sprite at a baked size (pivot is the coin center
+// or the top center of the enemy's sprite box)
+static void MeasureFrame(int sprite, float size, int* width, int* height, Vector2* anchor) {
+    if (sprite == SPRITE_ENEMY) {
+        int bodyWidth = (int)(size * 0.5f);
+        *width = bodyWidth + 2;
+        *height = (int)size + 2;
+        *anchor = { (float)(bodyWidth / 2 + 1), 1.0f };
+        return;
+    }
+    
+    int radius = (int)size;
+    int textSize = CoinTextSize(size);
+    int labelWidth = MeasureText(CoinLabel(sprite), textSize);
+    int halfWidth = labelWidth / 2 > radius * 2 ? labelWidth / 2 : radius * 2;
+    int above = radius + textSize + 8;
+    *width = halfWidth * 2 + 2;
+    *height = above + radius * 2 + 2;
+    *anchor = { (float)(halfWidth + 1), (float)(above + 1) };
+}
+
+// Same shapes DrawCollectibles used to draw per frame
+static void PaintCoin(int sprite, int centerX, int centerY, int radius) {
+    DrawCircle(centerX, centerY, radius * 2.0f, Color{255, 215, 0, 40});
+    DrawCircle(centerX, centerY, radius * 1.5f, Color{255, 215, 0, 80});
+    DrawCircle(centerX, centerY, radius, sprite == SPRITE_COIN ? GOLD : BLUE);
+    DrawCircle(centerX - radius/3, centerY - radius/3, (float)radius/3, YELLOW);
+    
+    int textSize = CoinTextSize((float)radius);
+    const char* label = CoinLabel(sprite);
+    int textWidth = MeasureText(label, textSize);
+    DrawText(label, centerX - textWidth/2, centerY - radius - textSize - 8, textSize,
+             sprite == SPRITE_COIN ? YELLOW : BLUE);
+}
+
+// Same shapes DrawEnemy used to draw per frame; eyes and knife scale with size
+static void PaintEnemy(int centerX, int drawStartY, int bodyHeight) {
+    int bodyWidth = bodyHeight / 2;
+    float detail = bodyHeight / 128.0f;
+    
+    // Body (dark red rectangle)
+    DrawRectangle(centerX - bodyWidth / 4, drawStartY + bodyHeight / 4,
+                 bodyWidth / 2, bodyHeight / 2, Color{100, 0, 0, 255});
+    
+    // Head (dark circle)
+    int headRadius = bodyWidth / 4;
+    DrawCircle(centerX, drawStartY + bodyHeight / 6, headRadius, Color{80, 0, 0, 255});
+    
+    // Eyes (glowing red)
+    DrawCircle(centerX - headRadius / 3, drawStartY + bodyHeight / 6, 2.0f * detail, RED);
+    DrawCircle(centerX + headRadius / 3, drawStartY + bodyHeight / 6, 2.0f * detail, RED);
+    
+    // Weapon hint (knife)
+    DrawLineEx({ (float)(centerX + bodyWidth / 3), (float)(drawStartY + bodyHeight / 2) },
+               { (float)(centerX + bodyWidth / 2), (float)(drawStartY + bodyHeight / 3) },
+               detail < 1.0f ? 1.0f : detail, LIGHTGRAY);
+}
+
+void LoadSpriteAtlas(SpriteAtlas* atlas) {
+    // Shelf-pack every frame into rows of ATLAS_WIDTH
+    Rectangle layout[SPRITE_COUNT][SPRITE_LEVELS];
+    int x = ATLAS_PADDING;
+    int y = ATLAS_PADDING;
+    int rowHeight = 0;
+    for (int level = SPRITE_LEVELS - 1; level >= 0; level--) {
+        for (int sprite = 0; sprite < SPRITE_COUNT; sprite++) {
+            SpriteFrame& frame = atlas->frames[sprite][level];
+            frame.size = sprite == SPRITE_ENEMY ? ENEMY_SIZES[level] : COIN_SIZES[level];
+            
+            int width, height;
+            MeasureFrame(sprite, frame.size, &width, &height, &frame.anchor);
+            if (x + width + ATLAS_PADDING > ATLAS_WIDTH) {
+                x = ATLAS_PADDING;
+                y += rowHeight + ATLAS_PADDING;
+                rowHeight = 0;
+            }
+            layout[sprite][level] = { (float)x, (float)y, (float)width, (float)height };
+            x += width + ATLAS_PADDING;
+            if (height > rowHeight) rowHeight = height;
+        }
+    }
+    int atlasHeight = y + rowHeight + ATLAS_PADDING;
+    
+    atlas->target = LoadRenderTexture(ATLAS_WIDTH, atlasHeight);
+    if (!IsRenderTextureReady(atlas->target)) {
+        TraceLog(LOG_ERROR, "Failed to create sprite atlas");
+        return;
+    }
+    SetTextureFilter(atlas->target.texture, TEXTURE_FILTER_BILINEAR);
+    
+    // Bake with premultiplied alpha so overlapping glow layers composite
+    // exactly like drawing them straight to the screen
+    BeginTextureMode(atlas->target);
+    ClearBackground(BLANK);
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA,
+                              RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    for (int sprite = 0; sprite < SPRITE_COUNT; sprite++) {
+        for (int level = 0; level < SPRITE_LEVELS; level++) {
+            SpriteFrame& frame = atlas->frames[sprite][level];
+            Rectangle rect = layout[sprite][level];
+            int pivotX = (int)(rect.x + frame.anchor.x);
+            int pivotY = (int)(rect.y + frame.anchor.y);
+            if (sprite == SPRITE_ENEMY) {
+                PaintEnemy(pivotX, pivotY, (int)frame.size);
+            } else {
+                PaintCoin(sprite, pivotX, pivotY, (int)frame.size);
+            }
+            
+            // Render textures are stored bottom-up
+            frame.source = { rect.x, atlasHeight - rect.y - rect.height, rect.width, -rect.height };
+        }
+    }
+    EndBlendMode();
+    EndTextureMode();
+    
+    TraceLog(LOG_INFO, "Sprite atlas baked (%dx%d)", ATLAS_WIDTH, atlasHeight);
+}
+
+void UnloadSpriteAtlas(SpriteAtlas* atlas) {
+    if (IsRenderTextureReady(atlas->target)) {
+        UnloadRenderTexture(atlas->target);
+    }
+    atlas->target = RenderTexture2D{0};
+}
+
+void DrawAtlasSprite(const SpriteAtlas* atlas, int sprite, Vector2 pos, float size) {
+    // Past the largest bake (a close enemy can fill the screen) a magnified
+    // texture would blur, so paint the shapes directly. They use straight
+    // alpha, so switch blending for them.
+    if (size > atlas->frames[sprite][SPRITE_LEVELS - 1].size) {
+        BeginBlendMode(BLEND_ALPHA);
+        if (sprite == SPRITE_ENEMY) {
+            PaintEnemy((int)pos.x, (int)pos.y, (int)size);
+        } else {
+            PaintCoin(sprite, (int)pos.x, (int)pos.y, (int)size);
+        }
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        return;
+    }
+    
+    // Smallest baked scale that covers the request, so sprites only shrink
+    const SpriteFrame* frame = &atlas->frames[sprite][SPRITE_LEVELS - 1];
+    for (int level = 0; level < SPRITE_LEVELS; level++) {
+        if (atlas->frames[sprite][level].size >= size) {
+            frame = &atlas->frames[sprite][level];
+            break;
+        }
+    }
+    
+    float scale = size / frame->size;
+    Rectangle dest = {
+        pos.x - frame->anchor.x * scale,
+        pos.y - frame->anchor.y * scale,
+        frame->source.width * scale,
+        -frame->source.height * scale
+    };
+    DrawTexturePro(atlas->target.texture, frame->source, dest, { 0.0f, 0.0f }, 0.0f, WHITE);
+}
@@ -0,0 +1,39 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <raylib.h>
+
+enum SpriteId {
+    SPRITE_COIN,
+    SPRITE_BOOST,
+    SPRITE_ENEMY,
+    SPRITE_COUNT
+};
+
+const int SPRITE_LEVELS = 4; // Pre-rendered scales per sprite
+
+// One pre-rendered scale of a sprite inside the atlas
+struct SpriteFrame {
+    Rectangle source; // Flipped for the render texture (negative height)
+    Vector2 anchor;   // Pivot inside the frame, in pixels
+    float size;       // Size parameter it was baked at (coin radius, enemy height)
+};
+
+// Billboard sprites baked once at startup into a single premultiplied-alpha
+// texture, so every sprite draw is one textured quad in the same batch.
+struct SpriteAtlas {
+    RenderTexture2D target;
+    SpriteFrame frames[SPRITE_COUNT][SPRITE_LEVELS];
+};
+
+// Bake all sprites (needs a window, call after InitWindow)
+void LoadSpriteAtlas(SpriteAtlas* atlas);
+
+void UnloadSpriteAtlas(SpriteAtlas* atlas);
+
+// Draw a sprite with its pivot at pos, scaled to size (same units as
+// SpriteFrame::size); sizes past the largest bake are painted directly. Call
+// between BeginBlendMode(BLEND_ALPHA_PREMULTIPLY) and EndBlendMode.
+void DrawAtlasSprite(const SpriteAtlas* atlas, int sprite, Vector2 pos, float size);
+
+#endif
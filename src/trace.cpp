@@ -0,0 +1,174 @@
+#include "trace.h"
+#include <raylib.h>
+#include <stdio.h>
+#include <chrono>
+
+std::atomic<bool> traceEnabled(false);
+
+// One event slot. Fields are relaxed atomics so a concurrent WriteTraceJson
+// is well defined; the sequence number tells it whether the slot was
+// rewritten while it was being read.
+struct TraceSlot {
+    std::atomic<unsigned long long> sequence; // Index of the event held + 1, 0 while being written
+    std::atomic<const char*> name;
+    std::atomic<long long> start;
+    std::atomic<long long> end;
+};
+
+// A thread's events. Only its owner writes. Rings are never freed: when the
+// owner exits, the ring stays readable until another thread claims it.
+struct TraceRing {
+    TraceSlot slots[TRACE_RING_EVENTS];
+    std::atomic<unsigned long long> head; // Events ever written
+    std::atomic<unsigned long long> clearedAt; // head when StartTrace last ran
+    std::atomic<const char*> threadName;
+    std::atomic<int> threadId;
+    std::atomic<bool> owned; // A live thread writes here
+    TraceRing* next;
+};
+
+// Hands the calling thread's ring back when the thread exits
+struct TraceRingOwner {
+    TraceRing* ring = nullptr;
+    
+    ~TraceRingOwner() {
+        if (ring) ring->owned.store(false, std::memory_order_release);
+    }
+};
+
+static std::atomic<TraceRing*> rings(nullptr);
+static std::atomic<int> nextThreadId(1);
+static thread_local TraceRingOwner threadRing;
+static thread_local const char* pendingThreadName = nullptr; // Until the thread has a ring
+
+static const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+long long TraceNowNs() {
+    // Never 0, which TraceScope uses for "off"
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch).count() + 1;
+}
+
+// Claim a ring left by an exited thread. Its old events are dropped, since
+// they would show up under the new thread's id.
+static TraceRing* ReuseRing() {
+    for (TraceRing* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        bool owned = false;
+        if (ring->owned.load(std::memory_order_relaxed) ||
+            !ring->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+            continue;
+        }
+        ring->clearedAt.store(ring->head.load());
+        return ring;
+    }
+    return nullptr;
+}
+
+static TraceRing* GetThreadRing() {
+    if (threadRing.ring) return threadRing.ring;
+    TraceRing* ring = ReuseRing();
+    if (ring == nullptr) {
+        ring = new TraceRing();
+        ring->owned.store(true);
+        TraceRing* first = rings.load();
+        do {
+            ring->next = first;
+        } while (!rings.compare_exchange_weak(first, ring));
+    }
+    ring->threadId.store(nextThreadId.fetch_add(1));
+    ring->threadName.store(pendingThreadName);
+    threadRing.ring = ring;
+    return ring;
+}
+
+void StartTrace() {
+    for (TraceRing* ring = rings.load(); ring; ring = ring->next) {
+        ring->clearedAt.store(ring->head.load());
+    }
+    traceEnabled.store(true);
+}
+
+void StopTrace() {
+    traceEnabled.store(false);
+}
+
+void SetTraceThreadName(const char* name) {
+    pendingThreadName = name;
+    if (threadRing.ring) threadRing.ring->threadName.store(name);
+}
+
+void AddTraceEvent(const char* name, long long startNs, long long endNs) {
+    TraceRing* ring = GetThreadRing();
+    unsigned long long index = ring->head.load(std::memory_order_relaxed);
+    TraceSlot& slot = ring->slots[index % TRACE_RING_EVENTS];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(startNs, std::memory_order_relaxed);
+    slot.end.store(endNs, std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+// JSON string contents: names are our own literals, but keep the file valid
+static void WriteJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+bool WriteTraceJson(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        TraceLog(LOG_ERROR, "Trace: cannot write %s", path);
+        return false;
+    }
+    
+    // Complete ("X") events with microsecond timestamps to 3 decimals, i.e. ns
+    fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    bool first = true;
+    int eventCount = 0;
+    for (TraceRing* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        int threadId = ring->threadId.load();
+        char fallbackName[32];
+        const char* name = ring->threadName.load();
+        if (name == nullptr) {
+            snprintf(fallbackName, sizeof(fallbackName), "thread %d", threadId);
+            name = fallbackName;
+        }
+        fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": ",
+                first ? "" : ",\n", threadId);
+        WriteJsonString(file, name);
+        fprintf(file, "}}");
+        first = false;
+            
+        unsigned long long head = ring->head.load(std::memory_order_acquire);
+        unsigned long long begin = ring->clearedAt.load();
+        if (head - begin > (unsigned long long)TRACE_RING_EVENTS) begin = head - TRACE_RING_EVENTS;
+        for (unsigned long long index = begin; index < head; index++) {
+            TraceSlot& slot = ring->slots[index % TRACE_RING_EVENTS];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1) continue;
+            const char* name = slot.name.load(std::memory_order_relaxed);
+            long long start = slot.start.load(std::memory_order_relaxed);
+            long long end = slot.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != index + 1) continue; // Rewritten meanwhile
+                
+            fprintf(file, ",\n{\"name\": ");
+            WriteJsonString(file, name);
+            fprintf(file, ", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %lld.%03lld, \"dur\": %lld.%03lld}",
+                    threadId, start / 1000, start % 1000, (end - start) / 1000, (end - start) % 1000);
+            eventCount++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    
+    bool ok = !ferror(file);
+    fclose(file);
+    if (ok) {
+        TraceLog(LOG_INFO, "Trace: wrote %d events to %s", eventCount, path);
+    }
+    return ok;
+}
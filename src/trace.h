@@ -0,0 +1,52 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+
+// Timeline tracing for chrome://tracing and Perfetto. TRACE_SCOPE records a
+// named duration event into the calling thread's own ring buffer: no locks,
+// no allocation after the thread's first traced event (threads that never
+// trace get no ring), and one relaxed load while tracing is off. Each ring
+// keeps its thread's last TRACE_RING_EVENTS events; when a thread exits its
+// ring goes to the next thread that starts tracing. WriteTraceJson can run
+// at any time and writes every thread's timeline, with nanosecond
+// timestamps, as Chrome trace-event JSON.
+
+const int TRACE_RING_EVENTS = 1 << 16; // Per thread, 2 MB
+
+extern std::atomic<bool> traceEnabled;
+
+// Clear every ring and start recording
+void StartTrace();
+
+void StopTrace();
+
+// Name the calling thread's timeline (the name must outlive the trace)
+void SetTraceThreadName(const char* name);
+
+// Write every thread's recorded events. Safe while threads keep tracing;
+// events overwritten during the write are left out.
+bool WriteTraceJson(const char* path);
+
+long long TraceNowNs();
+
+// Append a finished event to the calling thread's ring (name must be a literal)
+void AddTraceEvent(const char* name, long long startNs, long long endNs);
+
+struct TraceScope {
+    const char* name;
+    long long start; // 0 if tracing was off at entry
+    
+    explicit TraceScope(const char* name) : name(name) {
+        start = traceEnabled.load(std::memory_order_relaxed) ? TraceNowNs() : 0;
+    }
+    ~TraceScope() {
+        if (start != 0) AddTraceEvent(name, start, TraceNowNs());
+    }
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+
+#endif
@@ -0,0 +1,115 @@
+// Episode contract of the batch simulator: one instance walked through the
+// door and one caught by the enemy, checking dones, wins, the exit and death
+// rewards, and that the observation after the step shows the next episode.
+// Headless (no window). Exits 1 if any check fails.
+
+#include "batchsim.h"
+#include "level.h"
+#include "map.h"
+#include <stdio.h>
+#include <math.h>
+
+static int failures = 0;
+
+static void Check(bool ok, const char* what) {
+    if (!ok) {
+        printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static BatchConfig TestConfig() {
+    BatchConfig config = DefaultBatchConfig();
+    config.instances = 1;
+    config.threads = 1;
+    config.level = 2; // Levels after the first lead to the shop, and have an enemy
+    config.maxEpisodeSteps = 1000;
+    config.goldReward = 0.0f; // Rewards below come from the episode end only
+    config.exitReward = 2.0f;
+    config.deathPenalty = 3.0f;
+    return config;
+}
+
+// The freshly reset instance's observation, as the first step's would start
+static void CheckNewEpisode(const BatchSim* sim, Vector2 levelStart, const char* when) {
+    const GameState* game = &sim->games[0];
+    const float* state = &sim->state[0];
+    char what[128];
+    snprintf(what, sizeof(what), "%s: new episode is playing the configured level", when);
+    Check(game->mode == PLAYING && game->currentLevel == sim->config.level, what);
+    snprintf(what, sizeof(what), "%s: observation shows the level start with no gold", when);
+    Check(state[0] == levelStart.x && state[1] == levelStart.y && state[4] == 0.0f, what);
+    snprintf(what, sizeof(what), "%s: no background load was started", when);
+    Check(!game->loader.worker.joinable(), what);
+}
+
+// Put the player in the open cell next to a door, facing it, with gold to
+// pay for it and the enemy out of the way
+static bool PlaceAtDoor(GameState* game) {
+    MapView map = GetCurrentMapView();
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    for (int y = 0; y < map.height; y++) {
+        for (int x = 0; x < map.width; x++) {
+            if (GetMapTile(map, x, y) != 2) continue;
+            for (int d = 0; d < 4; d++) {
+                if (GetMapTile(map, x - dx[d], y - dy[d]) != 0) continue;
+                Vector2 start = { x - dx[d] + 0.5f, y - dy[d] + 0.5f };
+                game->player.position = start;
+                game->player.prevPosition = start;
+                game->player.angle = atan2f((float)dy[d], (float)dx[d]);
+                game->player.prevAngle = game->player.angle;
+                game->totalGold = game->doorCost;
+                game->enemy.isActive = false;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void TestExit(BatchSim* sim, Vector2 levelStart) {
+    Check(PlaceAtDoor(&sim->games[0]), "exit: level has a reachable door");
+    BatchAction forward = { 1.0f, 0.0f, 0.0f };
+    // dones still holds the previous step's result, so always take one step
+    int steps = 0;
+    do {
+        StepBatchSim(sim, &forward);
+        steps++;
+    } while (!sim->dones[0] && steps < 100);
+    Check(sim->dones[0] == 1, "exit: walking through the door ends the episode");
+    Check(sim->wins[0] == 1, "exit: the episode counts as a win");
+    Check(sim->rewards[0] == sim->config.exitReward, "exit: the step is rewarded with exitReward");
+    CheckNewEpisode(sim, levelStart, "exit");
+}
+
+static void TestDeath(BatchSim* sim, Vector2 levelStart) {
+    GameState* game = &sim->games[0];
+    game->enemy.isActive = true;
+    game->enemy.position = game->player.position;
+    game->enemy.prevPosition = game->player.position;
+    BatchAction idle = { 0.0f, 0.0f, 0.0f };
+    // dones still holds the previous step's result, so always take one step
+    int steps = 0;
+    do {
+        StepBatchSim(sim, &idle);
+        steps++;
+    } while (!sim->dones[0] && steps < 100);
+    Check(sim->dones[0] == 1, "death: being caught ends the episode");
+    Check(sim->wins[0] == 0, "death: the episode is not a win");
+    Check(sim->rewards[0] == -sim->config.deathPenalty, "death: the step is penalized by deathPenalty");
+    CheckNewEpisode(sim, levelStart, "death");
+}
+
+int main() {
+    BatchSim sim;
+    InitBatchSim(&sim, TestConfig());
+    Vector2 levelStart = sim.games[0].player.position;
+    
+    TestExit(&sim, levelStart);
+    TestDeath(&sim, levelStart);
+    
+    CloseBatchSim(&sim);
+    if (failures == 0) printf("batch episodes: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+// End-to-end frame-time scenarios: each one scripts input through the real
+// UpdateGame/DrawGame path in a hidden window for a fixed number of frames,
+// then compares the frame-time p50/p95 against a stored baseline.
+// Usage: scenarios [--scenario <name>] [--frames <n>] [--baseline <file>]
+//                  [--margin <fraction>] [--write-baseline <file>]
+// Exits 1 if a scenario is slower than baseline * (1 + margin), and 77 (CTest's
+// skip code) if a scenario has no baseline to compare against. Built with
+// ALLOC_TRACKING it also fails if any measured PLAYING frame allocates.
+
+#include <raylib.h>
+#include "game.h"
+#include "map.h"
+#include "rng.h"
+#include "alloctrack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+const int WARMUP_FRAMES = 60;
+const int EXIT_SKIPPED = 77; // No baseline entry: nothing to gate on
+const int TICKS_PER_FRAME = 2; // 60 FPS worth of simulation per frame
+
+struct Scenario {
+    const char* name;
+    void (*setup)(GameState* game);
+    void (*script)(GameState* game, int frame, GameInput* input); // Input and pinned state for one frame
+    int width;  // Window size for the run, 0 = the default
+    int height;
+};
+
+struct FrameStats {
+    float p50;
+    float p95;
+    float p99;
+    unsigned long long playingAllocs; // Heap allocations in measured PLAYING frames (ALLOC_TRACKING)
+};
+
+struct BaselineEntry {
+    std::string name;
+    FrameStats stats;
+};
+
+// Keep the sprint going and never let the chase end the run
+static void KeepPlayerAlive(GameState* game, Vector2 enemySpawn) {
+    game->player.hasSpeedBoost = true;
+    game->player.boostTimer = 10.0f;
+    if (game->isBeingAttacked || game->mode != PLAYING) {
+        game->mode = PLAYING;
+        game->isBeingAttacked = false;
+        game->stabEffectTimer = 0.0f;
+        game->enemy.position = enemySpawn;
+        game->enemy.prevPosition = enemySpawn;
+    }
+}
+
+static Vector2 chaseEnemySpawn;
+
+static void SetupLevel5Chase(GameState* game) {
+    InitLevel(game, 5);
+    game->player.hasSpeedBoost = true;
+    chaseEnemySpawn = game->enemy.position;
+}
+
+static void ScriptLevel5Chase(GameState* game, int frame, GameInput* input) {
+    // Sprint forward, sweeping the view so the walls and enemy keep changing
+    input->moveForward = true;
+    input->moveLeft = (frame / 90) % 2 == 0;
+    input->lookDelta = 6.0f;
+    KeepPlayerAlive(game, chaseEnemySpawn);
+}
+
+static void SetupStabEffect(GameState* game) {
+    InitLevel(game, 3);
+}
+
+static void ScriptStabEffect(GameState* game, int frame, GameInput* input) {
+    // Full-screen stab overlay every frame, held above the death threshold
+    game->isBeingAttacked = true;
+    game->stabEffectTimer = 2.0f;
+    input->lookDelta = 2.0f;
+    input->moveForward = (frame / 60) % 2 == 0;
+}
+
+static void SetupShop(GameState* game) {
+    game->currentLevel = 3;
+    game->totalGold = 500;
+    game->mode = SHOP;
+    GenerateShopPerks(game);
+}
+
+static void ScriptShop(GameState* game, int frame, GameInput* input) {
+    // Move the selection around without buying or leaving
+    input->perkPressed[(frame / 20) % 3] = true;
+    (void)game;
+}
+
+const int BIG_MAP_SIZE = 101; // 606 px minimap at the game's 6 px per cell
+static std::vector<int> bigMap;
+static Vector2 bigMapEnemySpawn;
+
+static void SetupBigMinimap(GameState* game) {
+    bigMap.resize(BIG_MAP_SIZE * BIG_MAP_SIZE);
+    GenerateMaze(bigMap.data(), BIG_MAP_SIZE, BIG_MAP_SIZE, 4242u);
+    SetCurrentMap(bigMap.data(), BIG_MAP_SIZE, BIG_MAP_SIZE);
+    
+    Vector2 start = { BIG_MAP_SIZE / 2 + 0.5f, BIG_MAP_SIZE / 2 + 0.5f };
+    game->player.position = start;
+    game->player.prevPosition = start;
+    game->doorCost = 100000;
+    game->currentLevel = MAX_LEVELS;
+    game->showEnemyOnMinimap = true;
+    PlaceCollectibles(game->collectibles, 600, 30, start, &game->rng);
+    InitEnemy(&game->enemy, start, BIG_MAP_SIZE, BIG_MAP_SIZE, 3);
+    bigMapEnemySpawn = game->enemy.position;
+    game->mode = PLAYING;
+}
+
+static void ScriptBigMinimap(GameState* game, int frame, GameInput* input) {
+    input->moveForward = true;
+    input->lookDelta = (frame / 120) % 2 == 0 ? 4.0f : -4.0f;
+    KeepPlayerAlive(game, bigMapEnemySpawn);
+}
+
+static const Scenario scenarios[] = {
+    { "level5_chase", SetupLevel5Chase, ScriptLevel5Chase, 0, 0 },
+    { "level5_chase_4k", SetupLevel5Chase, ScriptLevel5Chase, 3840, 2160 },
+    { "stab_effect", SetupStabEffect, ScriptStabEffect, 0, 0 },
+    { "shop", SetupShop, ScriptShop, 0, 0 },
+    { "big_minimap", SetupBigMinimap, ScriptBigMinimap, 0, 0 },
+};
+const int SCENARIO_COUNT = sizeof(scenarios) / sizeof(scenarios[0]);
+
+static float Percentile(std::vector<float> values, float fraction) {
+    std::sort(values.begin(), values.end());
+    int index = (int)ceilf(fraction * values.size()) - 1;
+    if (index < 0) index = 0;
+    return values[index];
+}
+
+static SpriteAtlas sprites; // Baked once, shared by every scenario
+
+static FrameStats RunScenario(const Scenario& scenario, int frames) {
+    SetWindowSize(scenario.width > 0 ? scenario.width : DEFAULT_SCREEN_WIDTH,
+                  scenario.height > 0 ? scenario.height : DEFAULT_SCREEN_HEIGHT);
+    GameState* game = new GameState();
+    RenderState* view = new RenderState();
+    SeedRng(&game->rng, 1);
+    InitGame(game);
+    game->sprites = sprites;
+    scenario.setup(game);
+    
+    std::vector<float> frameMs;
+    frameMs.reserve(frames);
+    GameInput input = {};
+    unsigned long long playingAllocs = 0;
+    for (int frame = 0; frame < WARMUP_FRAMES + frames; frame++) {
+        bool playing = game->mode == PLAYING;
+        AllocCounts allocsBefore = GetAllocTotals();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < TICKS_PER_FRAME; tick++) {
+            scenario.script(game, frame, &input);
+            input.levelReady = IsLevelLoadReady(&game->loader, game->currentLevel);
+            UpdateGame(game, &input, SIM_DT);
+            ConsumeGameInput(&input);
+        }
+        CaptureRenderState(game, view);
+        DrawGame(view, 0.5f, 0.0f);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (frame >= WARMUP_FRAMES) frameMs.push_back((float)(elapsed * 1000.0));
+        if (frame >= WARMUP_FRAMES && playing && game->mode == PLAYING) {
+            playingAllocs += GetAllocTotals().count - allocsBefore.count;
+        }
+    }
+    
+    CancelLevelLoad(&game->loader);
+    delete view;
+    delete game;
+    
+    FrameStats stats;
+    stats.p50 = Percentile(frameMs, 0.50f);
+    stats.p95 = Percentile(frameMs, 0.95f);
+    stats.p99 = Percentile(frameMs, 0.99f);
+    stats.playingAllocs = playingAllocs;
+    return stats;
+}
+
+// Baseline file: "name p50 p95 p99" per line (ms), '#' starts a comment
+static std::vector<BaselineEntry> LoadBaseline(const char* path) {
+    std::vector<BaselineEntry> entries;
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return entries;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char name[128];
+        BaselineEntry entry;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%127s %f %f %f", name, &entry.stats.p50, &entry.stats.p95, &entry.stats.p99) == 4) {
+            entry.name = name;
+            entries.push_back(entry);
+        }
+    }
+    fclose(file);
+    return entries;
+}
+
+static bool SaveBaseline(const char* path, const std::vector<BaselineEntry>& entries) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "scenarios: cannot write %s\n", path);
+        return false;
+    }
+    fprintf(file, "# Scenario frame-time baseline (ms): name p50 p95 p99\n");
+    fprintf(file, "# Record on the reference machine with: scenarios --write-baseline <this file>\n");
+    for (size_t i = 0; i < entries.size(); i++) {
+        fprintf(file, "%s %.3f %.3f %.3f\n", entries[i].name.c_str(),
+                entries[i].stats.p50, entries[i].stats.p95, entries[i].stats.p99);
+    }
+    fclose(file);
+    return true;
+}
+
+static BaselineEntry* FindBaseline(std::vector<BaselineEntry>& entries, const char* name) {
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].name == name) return &entries[i];
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    const char* only = NULL;
+    const char* baselinePath = NULL;
+    const char* writePath = NULL;
+    int frames = 600;
+    float margin = 0.25f;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            fprintf(stderr, "scenarios: option %s needs a value\n", argv[i]);
+            return 2;
+        }
+        if (strcmp(argv[i], "--scenario") == 0) only = argv[i + 1];
+        else if (strcmp(argv[i], "--frames") == 0) frames = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--baseline") == 0) baselinePath = argv[i + 1];
+        else if (strcmp(argv[i], "--margin") == 0) margin = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--write-baseline") == 0) writePath = argv[i + 1];
+        else {
+            fprintf(stderr, "scenarios: unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (frames < 1) frames = 1;
+    
+    // Offscreen: a hidden window still gives the real GL context and batching
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(DEFAULT_SCREEN_WIDTH, DEFAULT_SCREEN_HEIGHT, "MazeKiller3D scenarios");
+    LoadSpriteAtlas(&sprites);
+    
+    std::vector<BaselineEntry> baseline = LoadBaseline(writePath ? writePath : baselinePath ? baselinePath : "");
+    bool ran = false;
+    bool regressed = false;
+    bool missingBaseline = false;
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        if (only && strcmp(only, scenarios[s].name) != 0) continue;
+        ran = true;
+        FrameStats stats = RunScenario(scenarios[s], frames);
+        printf("%-16s p50 %7.3f ms  p95 %7.3f ms  p99 %7.3f ms", scenarios[s].name, stats.p50, stats.p95, stats.p99);
+        if (allocTrackingBuilt) {
+            printf("  allocs %llu", stats.playingAllocs);
+            regressed = regressed || stats.playingAllocs > 0;
+        }
+        
+        BaselineEntry* entry = FindBaseline(baseline, scenarios[s].name);
+        if (writePath) {
+            if (entry == NULL) {
+                baseline.push_back(BaselineEntry());
+                entry = &baseline.back();
+                entry->name = scenarios[s].name;
+            }
+            entry->stats = stats;
+            printf("  (recorded)\n");
+        } else if (entry == NULL) {
+            printf("  (no baseline, skipped)\n");
+            missingBaseline = true;
+        } else {
+            // p99 over a few hundred frames is too noisy to gate on; it is reported only
+            bool slow = stats.p50 > entry->stats.p50 * (1.0f + margin) ||
+                        stats.p95 > entry->stats.p95 * (1.0f + margin);
+            printf("  baseline p50 %.3f p95 %.3f: %s\n", entry->stats.p50, entry->stats.p95,
+                   slow ? "REGRESSED" : "ok");
+            regressed = regressed || slow;
+        }
+    }
+    
+    UnloadSpriteAtlas(&sprites);
+    CloseWindow();
+    if (!ran) {
+        fprintf(stderr, "scenarios: no scenario named %s\n", only);
+        return 2;
+    }
+    if (writePath && !SaveBaseline(writePath, baseline)) return 2;
+    if (regressed) return 1;
+    return missingBaseline ? EXIT_SKIPPED : 0;
+}
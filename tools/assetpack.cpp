@@ -0,0 +1,114 @@
+// Build-time packer for assets.pak (format in src/assetpack.h).
+// Usage: assetpack <output.pak> <asset files...>
+// Short sound effects are stored as decoded PCM so the game only copies
+// samples at load; everything else (the streamed music) is stored as is.
+
+#include <raylib.h>
+#include "assetpack.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static const unsigned int MAX_PCM_BYTES = 8 * 1024 * 1024; // Larger sounds stay compressed
+
+static bool WritePadding(FILE* out) {
+    static const unsigned char zeros[ASSET_PACK_ALIGN] = {0};
+    long position = ftell(out);
+    unsigned int padding = (ASSET_PACK_ALIGN - (unsigned int)(position % ASSET_PACK_ALIGN)) % ASSET_PACK_ALIGN;
+    return fwrite(zeros, 1, padding, out) == padding;
+}
+
+// Decode to PCM when it is a short sound effect; returns false to store the file
+static bool DecodeSound(const char* path, Wave* wave) {
+    const char* ext = GetFileExtension(path);
+    if (ext == NULL || strcmp(ext, ".mp3") == 0) return false;
+    if (strcmp(ext, ".wav") != 0 && strcmp(ext, ".ogg") != 0 &&
+        strcmp(ext, ".flac") != 0 && strcmp(ext, ".qoa") != 0) return false;
+    
+    *wave = LoadWave(path);
+    if (!IsWaveReady(*wave)) return false;
+    unsigned long long bytes = (unsigned long long)wave->frameCount * wave->channels * wave->sampleSize / 8;
+    if (bytes > MAX_PCM_BYTES) {
+        UnloadWave(*wave);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: assetpack <output.pak> <asset files...>\n");
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+    
+    FILE* out = fopen(argv[1], "wb");
+    if (out == NULL) {
+        fprintf(stderr, "assetpack: cannot write %s\n", argv[1]);
+        return 1;
+    }
+    
+    AssetPackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+    header.version = ASSET_PACK_VERSION;
+    fwrite(&header, sizeof(header), 1, out);
+    
+    std::vector<AssetPackEntry> entries;
+    for (int i = 2; i < argc; i++) {
+        const char* path = argv[i];
+        const char* name = GetFileName(path);
+        if (strlen(name) >= (size_t)ASSET_NAME_LENGTH) {
+            fprintf(stderr, "assetpack: name too long: %s\n", name);
+            fclose(out);
+            return 1;
+        }
+        
+        AssetPackEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        strcpy(entry.name, name);
+        WritePadding(out);
+        entry.offset = (unsigned long long)ftell(out);
+        
+        Wave wave;
+        if (DecodeSound(path, &wave)) {
+            entry.kind = ASSET_PCM;
+            entry.frameCount = wave.frameCount;
+            entry.sampleRate = wave.sampleRate;
+            entry.sampleSize = wave.sampleSize;
+            entry.channels = wave.channels;
+            entry.size = (unsigned long long)wave.frameCount * wave.channels * wave.sampleSize / 8;
+            fwrite(wave.data, 1, (size_t)entry.size, out);
+            UnloadWave(wave);
+        } else {
+            int size = 0;
+            unsigned char* bytes = LoadFileData(path, &size);
+            if (bytes == NULL) {
+                fprintf(stderr, "assetpack: cannot read %s\n", path);
+                fclose(out);
+                return 1;
+            }
+            entry.kind = ASSET_FILE;
+            entry.size = (unsigned long long)size;
+            fwrite(bytes, 1, (size_t)size, out);
+            UnloadFileData(bytes);
+        }
+        entries.push_back(entry);
+        printf("assetpack: %-24s %s %llu bytes\n", name, entry.kind == ASSET_PCM ? "pcm " : "file", entry.size);
+    }
+    
+    WritePadding(out);
+    header.tocOffset = (unsigned long long)ftell(out);
+    header.entryCount = (unsigned int)entries.size();
+    fwrite(entries.data(), sizeof(AssetPackEntry), entries.size(), out);
+    fseek(out, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, out);
+    
+    bool ok = !ferror(out);
+    fclose(out);
+    if (!ok) {
+        fprintf(stderr, "assetpack: write failed for %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}